@@ -4,6 +4,43 @@
 #include <vector>
 #include <map>
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <new>
+#include <type_traits>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define FIX_KEYWORD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang Լ  ɾ  Ѿ ϰ, MSVC  ɼ  intrinsic  
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_ISA(isa) __attribute__((target(isa)))
+#define NO_INLINE __attribute__((noinline))
+#else
+#define TARGET_ISA(isa)
+#define NO_INLINE __declspec(noinline)
+#endif
 
 #include "gmock/gmock.h"
 
@@ -14,8 +51,146 @@ struct Node {
 	string wk;
 };
 
+//   ڿ Ϻθ Ű 
+struct CharRange {
+	const char* first;
+	const char* last;
+
+	const char* data() const { return first; }
+	const char* begin() const { return first; }
+	const char* end() const { return last; }
+	size_t size() const { return static_cast<size_t>(last - first); }
+	bool empty() const { return first == last; }
+};
+
+CharRange rangeOf(const std::string& s) {
+	return { s.data(), s.data() + s.size() };
+}
+
+bool operator==(const CharRange& a, const std::string& b) {
+	return a.size() == b.size() && (b.empty() || std::memcmp(a.first, b.data(), b.size()) == 0);
+}
+
+//   / bigram  bucket 
+const int kHistogramBuckets = 64;
+
+// Ÿ    
+struct KeywordSketch {
+	int length = 0;
+	uint16_t histogram[kHistogramBuckets] = {}; //   (c & 63)
+	uint16_t bigrams[kHistogramBuckets] = {};   //   (q = 2) 
+};
+
+// Ű庰 intern     δ  
+struct MatchProfile {
+	bool ready = false;
+	bool hasPeq = false;                    // 64   Peq 
+	KeywordSketch sketch;
+	uint8_t slot[256] = {};                 //  -> masks index (0: Ͽ  )
+	uint64_t masks[65] = {};                //  ٸ ں ġ Ʈũ, masks[0] = 0
+};
+
+// Ű intern ̺
+//  Ű Ʈ ϳ arena ̾ ٿ ϰ dense 32Ʈ id ο
+// id MatchProfile    ΰ,   id 
+//  Ž Ź д ؽ/̴ profile и id  迭() 
+//    id ϸ,  arena Ʈ   
+// text() ִ   acquire/release  ȿ
+// arena Ű ( Ű Ŀų ) storageVersion() ٲǷ    ̰ Ȯ
+constexpr uint32_t kNoKeyword = 0xFFFFFFFFu;
+
+class KeywordTable {
+public:
+	uint32_t acquire(const std::string& keyword);   //  ߰,   
+	void addRef(uint32_t id) { entries_[id].refs++; }
+	void release(uint32_t id);
+	uint32_t find(const std::string& keyword) const; //  kNoKeyword
+
+	CharRange text(uint32_t id) const {
+		const char* base = arena_.data() + entries_[id].offset;
+		return { base, base + entries_[id].length };
+	}
+	const MatchProfile& profile(uint32_t id) const { return profiles_[id]; }
+	uint64_t hash(uint32_t id) const { return hashes_[id]; }
+	uint32_t length(uint32_t id) const { return entries_[id].length; }
+	size_t size() const { return live_; }
+	size_t arenaBytes() const { return arena_.size(); }
+	uint64_t storageVersion() const { return storageVersion_.load(std::memory_order_acquire); }
+
+private:
+	struct Entry {
+		uint32_t offset;
+		uint32_t length;
+		uint32_t refs;
+	};
+
+	uint32_t find(const char* s, size_t len, uint64_t hash) const;
+	uint32_t insert(const std::string& keyword, uint64_t hash);
+	void placeInIndex(uint32_t id);
+	void eraseFromIndex(uint32_t id);
+	void compact();
+
+	std::vector<char> arena_;
+	std::vector<Entry> entries_;
+	std::vector<uint64_t> hashes_;          // hashKeyword(text(id))
+	std::vector<MatchProfile> profiles_;
+	std::vector<uint32_t> freeIds_;
+	std::vector<uint32_t> index_;           //  Ž, kNoKeyword:  ĭ
+	size_t live_ = 0;
+	size_t garbage_ = 0;                    //  Ű尡 ϴ arena Ʈ
+	std::atomic<uint64_t> storageVersion_{ 0 };  // arena ̵ Ƚ
+};
+
+//  Ϻ  Ǿ ߿ Ҹؾ 
+KeywordTable g_keywords;
+
+// intern Ű忡   (id 4Ʈ)
+class InternedKeyword {
+public:
+	InternedKeyword() : id_(g_keywords.acquire(std::string())) {}
+	InternedKeyword(const std::string& keyword) : id_(g_keywords.acquire(keyword)) {}
+	InternedKeyword(const char* keyword) : id_(g_keywords.acquire(keyword)) {}
+	InternedKeyword(const InternedKeyword& other) : id_(other.id_) { g_keywords.addRef(id_); }
+	InternedKeyword(InternedKeyword&& other) noexcept : id_(other.id_) { other.id_ = kNoKeyword; }
+	~InternedKeyword() {
+		if (id_ != kNoKeyword)
+			g_keywords.release(id_);
+	}
+
+	InternedKeyword& operator=(const InternedKeyword& other) {
+		g_keywords.addRef(other.id_);
+		if (id_ != kNoKeyword)
+			g_keywords.release(id_);
+		id_ = other.id_;
+		return *this;
+	}
+	InternedKeyword& operator=(InternedKeyword&& other) noexcept {
+		std::swap(id_, other.id_);
+		return *this;
+	}
+
+	uint32_t id() const { return id_; }
+	CharRange text() const { return g_keywords.text(id_); }
+	const MatchProfile& profile() const { return g_keywords.profile(id_); }
+	uint64_t hash() const { return g_keywords.hash(id_); }
+	size_t size() const { return g_keywords.length(id_); }
+	bool empty() const { return size() == 0; }
+	std::string str() const { return std::string(text().begin(), text().end()); }
+
+private:
+	uint32_t id_;
+};
+
+bool operator==(const InternedKeyword& a, const std::string& b) {
+	return a.text() == b;
+}
+
+std::ostream& operator<<(std::ostream& out, const InternedKeyword& keyword) {
+	return out.write(keyword.text().data(), keyword.size());
+}
+
 struct Node2 {
-	string name;
+	InternedKeyword name;
 	int point;
 
 	bool operator<(const Node2& other) const {
@@ -23,460 +198,4882 @@ struct Node2 {
 	}
 };
 
+// Count-Min sketch  (Cormode & Muthukrishnan 2005)
+// depth ึ width counter, Ű ؽø ະ ٸ   HIT Ƚ 
+//  ޸𸮷 Ű  ϰ  Ű带  (Ű 64Ʈ ؽ÷θ )
+//  : ະ counter   ּڰ  ͸ ø (ġ  Ƚ ̻,   )
+// ȭ (TinyLFU, Einziger et al. 2017): kCountMinSampleSizeȸ ϸ  counter ,
+//   ȸ Ű尡 ׾ ø   HIT   
+// 鸸   ٸ Ű忡  ۵ ึ 65536, counter 16Ʈ (ȭ)  ࿡ 512KB
+constexpr size_t kCountMinDepth = 4;
+constexpr size_t kCountMinWidthBits = 16;
+constexpr size_t kCountMinWidth = size_t(1) << kCountMinWidthBits;
+constexpr uint64_t kCountMinSampleSize = 8 * kCountMinWidth;
+
+class CountMinSketch {
+public:
+	// HIT weightȸ ϰ  ġ ȯ
+	uint32_t add(uint64_t hash, uint32_t weight = 1) {
+		size_t columns[kCountMinDepth];
+		uint32_t lowest = kCounterMax;
+		for (size_t row = 0; row < kCountMinDepth; ++row) {
+			columns[row] = column(hash, row);
+			lowest = std::min<uint32_t>(lowest, counters_[row][columns[row]]);
+		}
+		const uint32_t raised = (lowest > kCounterMax - std::min(weight, kCounterMax)) ? kCounterMax : lowest + weight;
+		for (size_t row = 0; row < kCountMinDepth; ++row) {
+			uint16_t& counter = counters_[row][columns[row]];
+			counter = static_cast<uint16_t>(std::max<uint32_t>(counter, raised));
+		}
+		total_ += weight;
+		sampled_ += weight;
+		if (sampled_ >= kCountMinSampleSize) {
+			halve();
+			//    ̹ HIT ݿ 
+			return raised >> 1;
+		}
+		return raised;
+	}
+
+	// HIT Ƚ  (   Ű  0)
+	uint32_t estimate(uint64_t hash) const {
+		uint32_t lowest = kCounterMax;
+		for (size_t row = 0; row < kCountMinDepth; ++row)
+			lowest = std::min<uint32_t>(lowest, counters_[row][column(hash, row)]);
+		return lowest;
+	}
+
+	//  counter հ踦  ( ü ,  HIT ԰ پ)
+	void halve() {
+		for (auto& row : counters_) {
+			for (uint16_t& counter : row)
+				counter >>= 1;
+		}
+		total_ >>= 1;
+		sampled_ >>= 1;
+		generation_++;
+	}
+
+	void clear() {
+		std::memset(counters_, 0, sizeof(counters_));
+		total_ = 0;
+		sampled_ = 0;
+		generation_++;
+	}
+
+	uint64_t total() const { return total_; }
+
+	// halve() / clear() ٲ,  ̿ ġ  
+	unsigned generation() const { return generation_; }
+
+private:
+	static constexpr uint32_t kCounterMax = 0xFFFFu;
+
+	// ึ ٸ Ȧ   Ʈ   (multiply-shift)
+	static size_t column(uint64_t hash, size_t row) {
+		static const uint64_t kRowSeeds[kCountMinDepth] = {
+			0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full, 0x165667B19E3779F9ull, 0xD6E8FEB86659FD93ull
+		};
+		return static_cast<size_t>((hash * kRowSeeds[row]) >> (64 - kCountMinWidthBits));
+	}
+
+	uint16_t counters_[kCountMinDepth][kCountMinWidth] = {};
+	uint64_t total_ = 0;
+	uint64_t sampled_ = 0;
+	unsigned generation_ = 0;
+};
+
+//  Ϻ  (struct-of-arrays), ϰ   ؽ /  / hits   迭 
+// point (Node2::point) ΰ   
+// ĺ ȴ Ž(޸ Ű,  )  ˻    а,
+// id  Ű ǥ(entries_ / hashes_ / profile)    ĺ 
+// insertRanked / raiseRanked / eraseRanked  ű ״  ű, ٲ ׸ ϳ ٽ 
+// hits   heavy hitter (tier)  HIT ġ (   0)
+//   ٸ Ű HIT  counter øǷ    ,  Ǵ  lowestRanked() ٽ 
+//   (и ׸ hits  ȿϹǷ  ٽ  ʰ ״ ű)
+struct RankColumns {
+	explicit RankColumns(const CountMinSketch* tier = nullptr) : tier(tier) {}
+
+	const CountMinSketch* tier;
+	unsigned tierGeneration = 0;
+	std::vector<uint64_t> hashes;
+	std::vector<uint32_t> lengths;
+	std::vector<uint32_t> hits;
+
+	void reserve(size_t capacity) {
+		hashes.reserve(capacity);
+		lengths.reserve(capacity);
+		hits.reserve(capacity);
+	}
+
+	//  slot ׸ ٽ 
+	void assign(const std::vector<Node2>& list, size_t slot) {
+		hashes[slot] = list[slot].name.hash();
+		lengths[slot] = static_cast<uint32_t>(list[slot].name.size());
+		hits[slot] = tier ? tier->estimate(hashes[slot]) : 0;
+	}
+
+	//  at ׸  
+	void insert(const std::vector<Node2>& list, size_t at) {
+		hashes.insert(hashes.begin() + at, 0);
+		lengths.insert(lengths.begin() + at, 0);
+		hits.insert(hits.begin() + at, 0);
+		assign(list, at);
+	}
+
+	//  slot ׸  
+	void erase(size_t slot) {
+		hashes.erase(hashes.begin() + slot);
+		lengths.erase(lengths.begin() + slot);
+		hits.erase(hits.begin() + slot);
+	}
+
+	//  from ׸ to(from ̻)     ĭ  , to ٲ ׸
+	void move(const std::vector<Node2>& list, size_t from, size_t to) {
+		std::rotate(hashes.begin() + from, hashes.begin() + from + 1, hashes.begin() + to + 1);
+		std::rotate(lengths.begin() + from, lengths.begin() + from + 1, lengths.begin() + to + 1);
+		std::rotate(hits.begin() + from, hits.begin() + from + 1, hits.begin() + to + 1);
+		assign(list, to);
+	}
+
+	void rebuild(const std::vector<Node2>& list) {
+		hashes.resize(list.size());
+		lengths.resize(list.size());
+		hits.resize(list.size());
+		tierGeneration = tier ? tier->generation() : 0;
+		for (size_t i = 0; i < list.size(); ++i)
+			assign(list, i);
+	}
+
+	// (hits, point)   ׸ (    ), hits  point   ׸
+	//   ȿ    ġ ̹Ƿ,    ׸ ٽ о
+	//  ״  ݺϸ  ġ  ּڰ ( ȭǸ  ü ٽ )
+	size_t lowestRanked() {
+		if (tier && tierGeneration != tier->generation()) {
+			tierGeneration = tier->generation();
+			for (size_t i = 0; i < hits.size(); ++i)
+				hits[i] = tier->estimate(hashes[i]);
+		}
+		for (;;) {
+			// ּڰ  ϰ (б  )   ù ġ ã
+			uint32_t least = 0xFFFFFFFFu;
+			for (uint32_t value : hits)
+				least = std::min(least, value);
+			const size_t lowest = static_cast<size_t>(std::find(hits.begin(), hits.end(), least) - hits.begin());
+			if (!tier || hits.empty())
+				return lowest;
+			const uint32_t fresh = tier->estimate(hashes[lowest]);
+			if (fresh == hits[lowest])
+				return lowest;
+			hits[lowest] = fresh;
+		}
+	}
+};
+
+//   ׻ point  (front   ׸, back 1)
+// (insertRanked)  (raiseRanked)   ϹǷ д    ڿ top-K
 vector<Node2> DayBest[7]; // ~ Ͽ
 vector<Node2> twoBest[2]; //, ָ
 int UZ = 9;
 
+//  Ű ˻ 
+struct SimilarKeyword {
+	string name;
+	int score;
+};
+
+//   ϸ  (    ׸ 켱,  ̸  )
+void insertNearest(std::vector<SimilarKeyword>& nearest, size_t k, const std::string& name, int score) {
+	size_t pos = nearest.size();
+	for (size_t i = 0; i < nearest.size(); ++i) {
+		if (nearest[i].name == name)
+			return;
+		if (pos == nearest.size() && nearest[i].score < score)
+			pos = i;
+	}
+	if (pos >= k)
+		return;
+	nearest.insert(nearest.begin() + pos, { name, score });
+	if (nearest.size() > k)
+		nearest.pop_back();
+}
+
 // 絵    ߻ Ŭ
 class ISimilarityScorer {
 public:
 	virtual ~ISimilarityScorer() {}
 	virtual int score(const std::string& a, const std::string& b) const = 0;
+
+	//  threshold ̻ Ǵ (ü   ȭ )
+	virtual bool isSimilar(const std::string& a, const std::string& b, int threshold) const {
+		return score(a, b) >= threshold;
+	}
+
+	// query candidates   Ͽ threshold ̻ ù ° ĺ index ȯ ( -1)
+	virtual int findFirstSimilar(const std::string& query, const std::vector<Node2>& candidates, int threshold) const {
+		for (size_t i = 0; i < candidates.size(); ++i) {
+			if (isSimilar(candidates[i].name.str(), query, threshold))
+				return static_cast<int>(i);
+		}
+		return -1;
+	}
+
+	// threshold ̻ ĺ    k nearest  ( )
+	virtual void findNearest(const std::string& query, const std::vector<Node2>& candidates,
+		size_t k, int threshold, std::vector<SimilarKeyword>& nearest) const {
+		for (const Node2& candidate : candidates) {
+			const std::string name = candidate.name.str();
+			int s = score(name, query);
+			if (s >= threshold)
+				insertNearest(nearest, k, name, s);
+		}
+	}
 };
 
+// DP (⺻  )   (ª Է ȣ ,  Է 庰  )
+// stack_buf rows * kStackRowLen ũ⿩ 
+const size_t kStackRowLen = 128;
+
+int* levenshteinRows(size_t row_len, int* stack_buf, size_t rows = 2) {
+	if (row_len <= kStackRowLen)
+		return stack_buf;
+	thread_local std::vector<int> scratch;
+	if (scratch.size() < rows * row_len)
+		scratch.resize(rows * row_len);
+	return scratch.data();
+}
+
 // Ÿ Ÿ  ˰ (ڿ 絵 ˻)
+// ü    /    
 int levenshtein(const std::string& a, const std::string& b) {
 	const size_t len_a = a.size();
 	const size_t len_b = b.size();
 
-	std::vector<std::vector<int>> d(len_a + 1, std::vector<int>(len_b + 1));
+	int stack_buf[2 * kStackRowLen];
+	int* prev = levenshteinRows(len_b + 1, stack_buf);
+	int* cur = prev + len_b + 1;
 
-	for (size_t i = 0; i <= len_a; ++i) d[i][0] = i;
-	for (size_t j = 0; j <= len_b; ++j) d[0][j] = j;
+	for (size_t j = 0; j <= len_b; ++j) prev[j] = j;
 
 	for (size_t i = 1; i <= len_a; ++i) {
+		cur[0] = i;
 		for (size_t j = 1; j <= len_b; ++j) {
 			if (a[i - 1] == b[j - 1])
-				d[i][j] = d[i - 1][j - 1];
+				cur[j] = prev[j - 1];
 			else
-				d[i][j] = 1 + std::min({ d[i - 1][j], d[i][j - 1], d[i - 1][j - 1] });
+				cur[j] = 1 + std::min({ prev[j], cur[j - 1], prev[j - 1] });
 		}
+		std::swap(prev, cur);
 	}
-	return d[len_a][len_b];
+	return prev[len_b];
 }
 
-// Ÿ    
-class LevenshteinScorer : public ISimilarityScorer {
-public:
-	int score(const std::string& string1, const std::string& string2) const override {
-		if (string1.empty() && string2.empty()) 
-			return 100;
-		if (string1.empty() || string2.empty()) 
-			return 1;
+//    
+constexpr int SIMILAR_THRESHOLD = 80;
 
-		int dist = levenshtein(string1, string2);
-		int max_len = std::max(string1.length(), string2.length());
-		double similarity = 1.0 - (double)dist / max_len;
-		int score = 1 + static_cast<int>(similarity * 99);
-		return score;
+//  double    (1 + (1 - dist / max_len) * 99  )
+//  ߿  ʰ, Ʒ ǥ  Ÿӿ   ׽Ʈ 
+constexpr int legacyScoreFromDistance(int dist, int max_len) {
+	return 1 + static_cast<int>((1.0 - static_cast<double>(dist) / max_len) * 99);
+}
+
+// ǥ / Ÿ ǥ δ ִ 
+const int kDistanceTableLen = 1024;
+
+constexpr int gcdInt(int a, int b) {
+	while (b != 0) {
+		const int r = a % b;
+		a = b;
+		b = r;
 	}
+	return a;
+}
+
+//  double  99 * (L - d) L   1 - d / L ݿø  Ȯ  1 ۰ ⵵ 
+//  d L - d = k * (L / gcd(L, 99)), k = 0 .. gcd(L, 99) (ִ 100)̹Ƿ
+// ̸ "k°  1 " Ʈ    Ÿӿ    
+struct LegacyScoreCorrection {
+	uint64_t roundsDown[kDistanceTableLen + 1][2];
 };
 
-// scorer ü 
-LevenshteinScorer g_scorer;
+constexpr LegacyScoreCorrection makeLegacyScoreCorrection() {
+	LegacyScoreCorrection table = {};
+	for (int len = 1; len <= kDistanceTableLen; ++len) {
+		const int divisor = gcdInt(len, 99);
+		const int step = len / divisor;
+		for (int k = 0; k <= divisor; ++k) {
+			const int dist = len - k * step;
+			if (legacyScoreFromDistance(dist, len) < 1 + 99 * (len - dist) / len)
+				table.roundsDown[len][k >> 6] |= uint64_t(1) << (k & 63);
+		}
+	}
+	return table;
+}
 
-// ڿ 絵  Լ  Ÿ 
-using SimilarityFunc = int(*)(const std::string&, const std::string&);
+constexpr LegacyScoreCorrection kLegacyScoreCorrection = makeLegacyScoreCorrection();
 
-////  
-//int calcSimiler(const std::string& string1, const std::string& string2)
-//{
-//	if (string1.empty() && string2.empty())
-//		return 100;
-//	if (string1.empty() || string2.empty()) 
-//		return 1;
-//
-//	int dist = levenshtein(string1, string2);
-//	int max_len = std::max(string1.length(), string2.length());
-//	// 絵  (1.0:  , 0.0:  ٸ)
-//	double similarity = 1.0 - (double)dist / max_len;
-//
-//	int score = 1 + static_cast<int>(similarity * 99);
-//
-//	return score;
-//}
-//
-//// ߻ȭ Լ    ʱȭ
-//SimilarityFunc similarityFunc = calcSimiler;
+// Ÿ ->  ȯ (1 ~ 100),  길 
+// 1 + floor(99 * (max_len - dist) / max_len) ǥ ǥõ  1   double  ״ 
+// (max_len > kDistanceTableLen̸   Ȯ )
+constexpr int scoreFromDistance(int dist, int max_len) {
+	const int scaled = 99 * (max_len - dist);
+	int score = 1 + scaled / max_len;
+	if (max_len <= kDistanceTableLen && scaled % max_len == 0) {
+		const int k = (max_len - dist) / (max_len / gcdInt(max_len, 99));
+		if ((kLegacyScoreCorrection.roundsDown[max_len][k >> 6] >> (k & 63)) & 1)
+			score--;
+	}
+	return score;
+}
 
-////  ȯ
-//bool similer(const std::string& string1, const std::string& string2) {
-//	int score = similarityFunc(string1, string2);
-//	return (score >= 80);
-//}
+static_assert(scoreFromDistance(5, 11) == 54, "   55 ƴ 54");
 
-//  ȯ
-bool similer(const std::string& string1, const std::string& string2) {
-	int score = g_scorer.score(string1, string2);
-	return (score >= 80);
+// scoreFromDistance(d, L) >= threshold  ϴ ִ d ( )
+// Ȯ   迡  1   ĭ   (   99 / L ̻ )
+constexpr int integerMaxDistance(int max_len, int threshold) {
+	if (threshold > 100)
+		return -1;
+	if (threshold <= 1 || max_len == 0)
+		return max_len;
+	const int dist = max_len * (100 - threshold) / 99;
+	return (scoreFromDistance(dist, max_len) < threshold) ? dist - 1 : dist;
 }
 
-//bool similer(const std::string& string1, const std::string& string2) {
-//	int score = calcSimiler(string1, string2);
-//	return (score >= 80);
-//}
-
-//  -> ε 
-map<string, int> dayToIndex = {
-	{"monday", 0}, {"tuesday", 1}, {"wednesday", 2},
-	{"thursday", 3}, {"friday", 4}, {"saturday", 5}, {"sunday", 6}
+// ̺ SIMILAR_THRESHOLD  ִ Ÿ ( Ÿ )
+struct DistanceBoundTable {
+	int maxDist[kDistanceTableLen + 1];
 };
 
-void resetScore();
-int increaseNodePoint(int point);
-void addKeyword(std::vector<Node2>& node, std::string& keyword, int point);
+constexpr DistanceBoundTable makeDistanceBoundTable(int threshold) {
+	DistanceBoundTable table = {};
+	for (int len = 0; len <= kDistanceTableLen; ++len)
+		table.maxDist[len] = integerMaxDistance(len, threshold);
+	return table;
+}
 
-string updateKeywordBy(string keyword, string day) {
-	UZ++;
+constexpr DistanceBoundTable kSimilarDistanceBound = makeDistanceBoundTable(SIMILAR_THRESHOLD);
+static_assert(kSimilarDistanceBound.maxDist[10] == 2, "10 Ű 2ڱ ");
 
-	int day_index = dayToIndex[day];
-	int weekend_index = (day_index >= dayToIndex["monday"] && day_index <= dayToIndex["friday"]) ? 0 : 1;
+// threshold ̻    ִ ִ Ÿ (Ұϸ -1)
+int maxDistanceFor(int max_len, int threshold) {
+	if (threshold == SIMILAR_THRESHOLD && max_len <= kDistanceTableLen)
+		return kSimilarDistanceBound.maxDist[max_len];
 
-	int point = UZ;
+	return integerMaxDistance(max_len, threshold);
+}
 
-	// Ͽ ϴ Ȯ
-	//Ǵ Ű̸  
+// Ÿ maxDist  ʿ  Ÿ Ÿ
+// 밢 band(|i - j| <= maxDist) ä,    maxDist   
+// maxDist  maxDist + 1 ȯ
+template <typename CharT>
+int levenshteinBoundedRaw(const CharT* a, int len_a, const CharT* b, int len_b, int maxDist) {
+	const int over = maxDist + 1;
 
-	long long int maxPoint_day = 0;
-	long long int maxPoint_weekdayOrWeekend = 0;
+	if (maxDist < 0 || std::abs(len_a - len_b) > maxDist)
+		return over;
 
-	bool isPerfectHit = false;
-	for (Node2& node : DayBest[day_index]) {
-		if (node.name == keyword) {
-			maxPoint_day = node.point = increaseNodePoint(node.point);
-			isPerfectHit = true;
-			break;
+	int stack_buf[2 * kStackRowLen];
+	int* prev = levenshteinRows(len_b + 1, stack_buf);
+	int* cur = prev + len_b + 1;
+
+	for (int j = 0; j <= len_b; ++j) prev[j] = (j <= maxDist) ? j : over;
+
+	for (int i = 1; i <= len_a; ++i) {
+		const int j_lo = std::max(1, i - maxDist);
+		const int j_hi = std::min(len_b, i + maxDist);
+
+		cur[j_lo - 1] = (j_lo == 1 && i <= maxDist) ? i : over;
+		int row_min = cur[j_lo - 1];
+
+		for (int j = j_lo; j <= j_hi; ++j) {
+			int v;
+			if (a[i - 1] == b[j - 1])
+				v = prev[j - 1];
+			else
+				v = 1 + std::min({ prev[j], cur[j - 1], prev[j - 1] });
+			if (v > over) v = over;
+			cur[j] = v;
+			if (v < row_min) row_min = v;
 		}
+		if (j_hi < len_b)
+			cur[j_hi + 1] = over;
+
+		if (row_min > maxDist)
+			return over;
+		std::swap(prev, cur);
 	}
+	return std::min(prev[len_b], over);
+}
 
-	for (Node2& node : twoBest[weekend_index]) {
-		if (node.name == keyword) {
-			maxPoint_weekdayOrWeekend = node.point = increaseNodePoint(node.point);
+//  λ  (8Ʈ     Ʈ )
+size_t commonPrefixLength(const char* a, const char* b, size_t n) {
+	size_t i = 0;
+	while (i + 8 <= n) {
+		uint64_t x, y;
+		std::memcpy(&x, a + i, 8);
+		std::memcpy(&y, b + i, 8);
+		if (x != y)
 			break;
-		}
+		i += 8;
 	}
+	while (i < n && a[i] == b[i])
+		++i;
+	return i;
+}
 
-	// ۾
-	if (UZ >= 2100000000 || maxPoint_day >= 2100000000 || maxPoint_weekdayOrWeekend >= 2100000000) {
-		resetScore();
+//  ̻  (a_end, b_end  ڿ )
+size_t commonSuffixLength(const char* a_end, const char* b_end, size_t n) {
+	size_t i = 0;
+	while (i + 8 <= n) {
+		uint64_t x, y;
+		std::memcpy(&x, a_end - i - 8, 8);
+		std::memcpy(&y, b_end - i - 8, 8);
+		if (x != y)
+			break;
+		i += 8;
 	}
+	while (i < n && a_end[-1 - static_cast<ptrdiff_t>(i)] == b_end[-1 - static_cast<ptrdiff_t>(i)])
+		++i;
+	return i;
+}
 
-	//Ϻ HIT
-	if (isPerfectHit) {
-		return keyword;
-	}
+template <typename CharT>
+size_t commonPrefixLength(const CharT* a, const CharT* b, size_t n) {
+	size_t i = 0;
+	while (i < n && a[i] == b[i])
+		++i;
+	return i;
+}
+
+template <typename CharT>
+size_t commonSuffixLength(const CharT* a_end, const CharT* b_end, size_t n) {
+	size_t i = 0;
+	while (i < n && a_end[-1 - static_cast<ptrdiff_t>(i)] == b_end[-1 - static_cast<ptrdiff_t>(i)])
+		++i;
+	return i;
+}
+
+//  λ/̻ Ÿ  Ƿ DP  ߶
+struct AffixTrim {
+	size_t prefix;
+	size_t suffix;
+};
+
+template <typename CharT>
+AffixTrim trimCommonAffixes(const CharT* a, size_t len_a, const CharT* b, size_t len_b) {
+	const size_t shorter = std::min(len_a, len_b);
+	AffixTrim trim;
+	trim.prefix = commonPrefixLength(a, b, shorter);
+	trim.suffix = commonSuffixLength(a + len_a, b + len_b, shorter - trim.prefix);
+	return trim;
+}
 
-	// HIT
-	for (Node2& node : DayBest[day_index]) {
-		if (similer(node.name, keyword)) {
-			return node.name;
+//  λ/̻縦 ߶  band DP  (Text: std::string, CharRange Ǵ ڵ Ʈ 迭)
+template <typename TextA, typename TextB>
+int levenshteinBounded(const TextA& a, const TextB& b, int maxDist) {
+	const AffixTrim trim = trimCommonAffixes(a.data(), a.size(), b.data(), b.size());
+	const size_t cut = trim.prefix + trim.suffix;
+	return levenshteinBoundedRaw(a.data() + trim.prefix, static_cast<int>(a.size() - cut),
+		b.data() + trim.prefix, static_cast<int>(b.size() - cut), maxDist);
+}
+
+void buildSketch(const std::string& s, KeywordSketch& sketch) {
+	sketch = KeywordSketch();
+	sketch.length = static_cast<int>(s.size());
+	for (size_t i = 0; i < s.size(); ++i) {
+		unsigned char c = s[i];
+		sketch.histogram[c & (kHistogramBuckets - 1)]++;
+		if (i > 0) {
+			unsigned char p = s[i - 1];
+			sketch.bigrams[(p * 7 + c) & (kHistogramBuckets - 1)]++;
 		}
 	}
+}
 
-	for (Node2& node : twoBest[weekend_index]) {
-		if (similer(node.name, keyword)) {
-			return node.name;
-		}
+//  ̷  Ÿ : ġȯ 1ȸ   1 ڶ  1 ÿ ؼ
+int histogramDistanceBound(const uint16_t* h1, const uint16_t* h2) {
+	int surplus = 0;
+	int deficit = 0;
+	for (int k = 0; k < kHistogramBuckets; ++k) {
+		int diff = h1[k] - h2[k];
+		if (diff > 0) surplus += diff;
+		else deficit -= diff;
 	}
+	return std::max(surplus, deficit);
+}
 
-	//Ϻ HIT /  HIT Ѵ ƴѰ
-	auto& dayNode = DayBest[day_index];
-	addKeyword(dayNode, keyword, point);
+//  bigram  (bucket ġ  ũ Ƿ  ˻翡 )
+int commonBigrams(const uint16_t* b1, const uint16_t* b2) {
+	int common = 0;
+	for (int k = 0; k < kHistogramBuckets; ++k)
+		common += std::min(b1[k], b2[k]);
+	return common;
+}
 
-	auto& twoNode = twoBest[weekend_index];
-	addKeyword(twoNode, keyword, point);
+//  ˻ ܰ躰  ( Ʈȿ ܰ躰   Ȯο)
+struct PrefilterStats {
+	long long checked = 0;
+	long long rejectedByLength = 0;
+	long long rejectedByHistogram = 0;
+	long long rejectedByBigram = 0;
+	long long passed = 0;
+};
 
-	return keyword;
+PrefilterStats g_prefilterStats;
+
+// ü Ÿ   Ÿ  maxDist Ѵ ĺ ɷ
+// 1)    2)     3) q-gram  (Ÿ k ̸  bigram >= max_len - 1 - 2k)
+//  Ѹ  ˻ (ĺ profile б    Ÿ)
+// ϸ passesPrefilters  Ѱ Բ ٽ 
+bool rejectedByLength(int len_a, int len_b, int maxDist) {
+	if (std::abs(len_a - len_b) <= maxDist)
+		return false;
+	g_prefilterStats.checked++;
+	g_prefilterStats.rejectedByLength++;
+	return true;
 }
 
-void addKeyword(std::vector<Node2>& node, std::string& keyword, int point)
-{
-	if (node.size() < 10) {
-		node.push_back({ keyword, point });
-		std::sort(node.begin(), node.end());
+// bigramsPerEdit:  1ȸ ߸  ִ bigram  (Ÿ 2, ġ ϴ OSA 3)
+bool passesPrefilters(const KeywordSketch& a, const KeywordSketch& b, int maxDist, int bigramsPerEdit = 2) {
+	g_prefilterStats.checked++;
+	if (std::abs(a.length - b.length) > maxDist) {
+		g_prefilterStats.rejectedByLength++;
+		return false;
 	}
-
-	if (node.size() == 10) {
-		if (node.back().point < point) {
-			node.pop_back();
-			node.push_back({ keyword, point });
-			std::sort(node.begin(), node.end());
-		}
+	if (histogramDistanceBound(a.histogram, b.histogram) > maxDist) {
+		g_prefilterStats.rejectedByHistogram++;
+		return false;
 	}
+	if (commonBigrams(a.bigrams, b.bigrams) < std::max(a.length, b.length) - 1 - bigramsPerEdit * maxDist) {
+		g_prefilterStats.rejectedByBigram++;
+		return false;
+	}
+	g_prefilterStats.passed++;
+	return true;
+}
+
+void printPrefilterStats(std::ostream& out) {
+	const PrefilterStats& st = g_prefilterStats;
+	double total = st.checked ? static_cast<double>(st.checked) : 1.0;
+	out << "prefilter checked=" << st.checked
+		<< " length=" << st.rejectedByLength << " (" << 100.0 * st.rejectedByLength / total << "%)"
+		<< " histogram=" << st.rejectedByHistogram << " (" << 100.0 * st.rejectedByHistogram / total << "%)"
+		<< " bigram=" << st.rejectedByBigram << " (" << 100.0 * st.rejectedByBigram / total << "%)"
+		<< " passed=" << st.passed << "\n";
 }
 
+// Ÿ    
+class LevenshteinScorer : public ISimilarityScorer {
+public:
+	int score(const std::string& string1, const std::string& string2) const override {
+		if (string1.empty() && string2.empty()) 
+			return 100;
+		if (string1.empty() || string2.empty()) 
+			return 1;
 
-void findBetterKeywords() {
-	ifstream fin{ "keyword_weekday_500.txt" }; //500  Է
-	for (int i = 0; i < 500; i++) {
-		string keyword, day;
-		fin >> keyword >> day;
-		string ret = updateKeywordBy(keyword, day);
-		std::cout << ret << "\n";
+		int dist = levenshtein(string1, string2);
+		int max_len = std::max(string1.length(), string2.length());
+		return scoreFromDistance(dist, max_len);
+	}
+
+	bool isSimilar(const std::string& string1, const std::string& string2, int threshold) const override {
+		if (string1.empty() && string2.empty())
+			return 100 >= threshold;
+		if (string1.empty() || string2.empty())
+			return 1 >= threshold;
+		if (string1 == string2)
+			return 100 >= threshold;
+
+		int max_len = std::max(string1.length(), string2.length());
+		int max_dist = maxDistanceFor(max_len, threshold);
+		if (max_dist < 0)
+			return false;
+
+		KeywordSketch sketch1, sketch2;
+		buildSketch(string1, sketch1);
+		buildSketch(string2, sketch2);
+		if (!passesPrefilters(sketch1, sketch2, max_dist))
+			return false;
+		return levenshteinBounded(string1, string2, max_dist) <= max_dist;
 	}
+};
+
+// Ʈ (Myers/Hyyro) Ÿ Ÿ 
+// ª  ڿ  ΰ 64Ʈ     
+//  ں ġ Ʈũ(Peq)
+void buildPeq64(const std::string& pattern, uint64_t* peq) {
+	std::fill(peq, peq + 256, 0ull);
+	for (size_t i = 0; i < pattern.size(); ++i)
+		peq[static_cast<unsigned char>(pattern[i])] |= 1ull << i;
 }
 
+// ̸  Peq text Ÿ  (peq(c)  c ġ Ʈũ)
+//  text  ŭ پ maxDist  maxDist + 1 ȯ
+template <typename PeqLookup, typename Text>
+int myersDistance64(PeqLookup peq, size_t m, const Text& text, int maxDist) {
+	const uint64_t last = 1ull << (m - 1);
+	uint64_t vp = ~0ull;
+	uint64_t vn = 0;
+	int dist = static_cast<int>(m);
+	int remaining = static_cast<int>(text.size());
 
-// test ///////////////
+	for (auto c : text) {
+		uint64_t x = peq(c) | vn;
+		uint64_t d0 = (((x & vp) + vp) ^ vp) | x;
+		uint64_t hp = vn | ~(d0 | vp);
+		uint64_t hn = vp & d0;
+		if (hp & last) dist++;
+		if (hn & last) dist--;
+		hp = (hp << 1) | 1;
+		hn = hn << 1;
+		vp = hn | ~(d0 | hp);
+		vn = hp & d0;
 
-TEST(KeywordTest, PerfectHit) {
-	string keyword = "banana";
-	string day = "tuesday";
-	updateKeywordBy(keyword, day); //  ߰
-	int prevPoint = DayBest[1][0].point;
-	string result = updateKeywordBy(keyword, day); // Ϻ HIT
-	EXPECT_EQ(result, keyword);
+		if (dist - --remaining > maxDist)
+			return maxDist + 1;
+	}
+	return dist;
 }
 
-TEST(KeywordTest, BasicAssertions) {
-	string keyword = "test_keyword";
-	string day = "monday";
-	string result = updateKeywordBy(keyword, day);
-	EXPECT_EQ(result, keyword); 
+int levenshteinBitParallel64(const std::string& pattern, const std::string& text) {
+	uint64_t peq[256];
+	buildPeq64(pattern, peq);
+	return myersDistance64([&](unsigned char c) { return peq[c]; },
+		pattern.size(), text, std::numeric_limits<int>::max() - 1);
 }
 
-TEST(KeywordTest, UZ_weekday) {
-	UZ = 2100000000;
-	updateKeywordBy("assd", "monday");
-	EXPECT_EQ(UZ, 9);
+// 64Ʈ FNV-1a
+uint64_t hashKeyword(const char* s, size_t len) {
+	uint64_t h = 1469598103934665603ull;
+	for (size_t i = 0; i < len; ++i) {
+		h ^= static_cast<unsigned char>(s[i]);
+		h *= 1099511628211ull;
+	}
+	return h;
 }
 
-TEST(KeywordTest, UZ_weekend) {
-	UZ = 2100000000;
-	updateKeywordBy("assd", "sunday");
-	EXPECT_EQ(UZ, 9);
+uint64_t hashKeyword(const std::string& s) {
+	return hashKeyword(s.data(), s.size());
+}
+
+MatchProfile buildMatchProfile(const std::string& name) {
+	MatchProfile profile;
+	profile.ready = true;
+	buildSketch(name, profile.sketch);
+	if (name.size() <= 64) {
+		profile.hasPeq = true;
+		int distinct = 0;
+		for (size_t i = 0; i < name.size(); ++i) {
+			uint8_t& slot = profile.slot[static_cast<unsigned char>(name[i])];
+			if (slot == 0)
+				slot = static_cast<uint8_t>(++distinct);
+			profile.masks[slot] |= 1ull << i;
+		}
+	}
+	return profile;
+}
+
+uint32_t KeywordTable::acquire(const std::string& keyword) {
+	const uint64_t hash = hashKeyword(keyword);
+	uint32_t id = find(keyword.data(), keyword.size(), hash);
+	if (id == kNoKeyword)
+		id = insert(keyword, hash);
+	entries_[id].refs++;
+	return id;
+}
+
+uint32_t KeywordTable::find(const std::string& keyword) const {
+	return find(keyword.data(), keyword.size(), hashKeyword(keyword));
+}
+
+uint32_t KeywordTable::find(const char* s, size_t len, uint64_t hash) const {
+	if (index_.empty())
+		return kNoKeyword;
+	const size_t mask = index_.size() - 1;
+	for (size_t i = hash & mask;; i = (i + 1) & mask) {
+		const uint32_t id = index_[i];
+		if (id == kNoKeyword)
+			return kNoKeyword;
+		const Entry& entry = entries_[id];
+		if (hashes_[id] == hash && entry.length == len
+			&& (len == 0 || std::memcmp(arena_.data() + entry.offset, s, len) == 0))
+			return id;
+	}
+}
+
+uint32_t KeywordTable::insert(const std::string& keyword, uint64_t hash) {
+	uint32_t id;
+	if (!freeIds_.empty()) {
+		id = freeIds_.back();
+		freeIds_.pop_back();
+	}
+	else {
+		id = static_cast<uint32_t>(entries_.size());
+		entries_.push_back(Entry());
+		hashes_.push_back(0);
+		profiles_.push_back(MatchProfile());
+	}
+	entries_[id] = { static_cast<uint32_t>(arena_.size()), static_cast<uint32_t>(keyword.size()), 0 };
+	const char* before = arena_.data();
+	arena_.insert(arena_.end(), keyword.begin(), keyword.end());
+	if (arena_.data() != before)
+		storageVersion_.fetch_add(1, std::memory_order_release);
+	hashes_[id] = hash;
+	profiles_[id] = buildMatchProfile(keyword);
+	live_++;
+
+	//  1/2  
+	if (live_ * 2 > index_.size()) {
+		index_.assign(std::max<size_t>(64, index_.size() * 2), kNoKeyword);
+		for (uint32_t other = 0; other < entries_.size(); ++other) {
+			if (other == id || entries_[other].refs > 0)
+				placeInIndex(other);
+		}
+	}
+	else {
+		placeInIndex(id);
+	}
+	return id;
+}
+
+void KeywordTable::placeInIndex(uint32_t id) {
+	const size_t mask = index_.size() - 1;
+	size_t i = hashes_[id] & mask;
+	while (index_[i] != kNoKeyword)
+		i = (i + 1) & mask;
+	index_[i] = id;
+}
+
+//  Ž backward-shift  (tombstone )
+//  ĭ  ׸   ġ ( ĭ,  ĭ]   ׸  ĭ 
+void KeywordTable::eraseFromIndex(uint32_t id) {
+	const size_t mask = index_.size() - 1;
+	size_t hole = hashes_[id] & mask;
+	while (index_[hole] != id)
+		hole = (hole + 1) & mask;
+
+	for (size_t j = (hole + 1) & mask; index_[j] != kNoKeyword; j = (j + 1) & mask) {
+		const size_t home = hashes_[index_[j]] & mask;
+		const bool stays = (hole <= j) ? (hole < home && home <= j) : (hole < home || home <= j);
+		if (!stays) {
+			index_[hole] = index_[j];
+			hole = j;
+		}
+	}
+	index_[hole] = kNoKeyword;
+}
+
+void KeywordTable::release(uint32_t id) {
+	Entry& entry = entries_[id];
+	if (--entry.refs > 0)
+		return;
+	eraseFromIndex(id);
+	freeIds_.push_back(id);
+	garbage_ += entry.length;
+	live_--;
+	if (garbage_ >= 4096 && garbage_ * 2 > arena_.size())
+		compact();
+}
+
+void KeywordTable::compact() {
+	std::vector<char> packed;
+	packed.reserve(arena_.size() - garbage_);
+	for (Entry& entry : entries_) {
+		if (entry.refs == 0)
+			continue;
+		const uint32_t offset = static_cast<uint32_t>(packed.size());
+		packed.insert(packed.end(), arena_.begin() + entry.offset, arena_.begin() + entry.offset + entry.length);
+		entry.offset = offset;
+	}
+	arena_.swap(packed);
+	garbage_ = 0;
+	storageVersion_.fetch_add(1, std::memory_order_release);
+}
+
+// ĺ profile  Ͽ text Ÿ 
+int myersDistanceProfile(const MatchProfile& profile, const std::string& text, int maxDist) {
+	return myersDistance64([&](unsigned char c) { return profile.masks[profile.slot[c]]; },
+		profile.sketch.length, text, maxDist);
+}
+
+//  λ/̻縦 ߶  profile Ÿ 
+// ߸  Peq  Ʈũ prefixŭ   ̷ ڸ 
+template <typename Name, typename Text>
+int myersDistanceProfileTrimmed(const MatchProfile& profile, const Name& name, const Text& text, int maxDist) {
+	const AffixTrim trim = trimCommonAffixes(name.data(), name.size(), text.data(), text.size());
+	const size_t m = name.size() - trim.prefix - trim.suffix;
+	const CharRange rest = { text.data() + trim.prefix, text.data() + text.size() - trim.suffix };
+	if (m == 0)
+		return std::min(static_cast<int>(rest.size()), maxDist + 1);
+
+	const unsigned shift = static_cast<unsigned>(trim.prefix);
+	const uint64_t keep = (m == 64) ? ~0ull : ((1ull << m) - 1);
+	return myersDistance64([&](unsigned char c) { return (profile.masks[profile.slot[c]] >> shift) & keep; },
+		m, rest, maxDist);
+}
+
+// 64ڸ Ѵ      carry 
+int levenshteinBitParallelBlock(const std::string& pattern, const std::string& text) {
+	const size_t m = pattern.size();
+	const size_t words = (m + 63) / 64;
+
+	thread_local std::vector<uint64_t> peq;
+	thread_local std::vector<uint64_t> vp;
+	thread_local std::vector<uint64_t> vn;
+	peq.assign(words * 256, 0);
+	vp.assign(words, ~0ull);
+	vn.assign(words, 0);
+
+	for (size_t i = 0; i < m; ++i)
+		peq[(i / 64) * 256 + static_cast<unsigned char>(pattern[i])] |= 1ull << (i % 64);
+
+	const uint64_t last = 1ull << ((m - 1) % 64);
+	int dist = static_cast<int>(m);
+
+	for (unsigned char c : text) {
+		uint64_t hp_carry = 1;
+		uint64_t hn_carry = 0;
+		for (size_t w = 0; w < words; ++w) {
+			uint64_t x = peq[w * 256 + c] | hn_carry;
+			uint64_t d0 = (((x & vp[w]) + vp[w]) ^ vp[w]) | x | vn[w];
+			uint64_t hp = vn[w] | ~(d0 | vp[w]);
+			uint64_t hn = d0 & vp[w];
+
+			uint64_t hp_in = hp_carry;
+			uint64_t hn_in = hn_carry;
+			if (w + 1 < words) {
+				hp_carry = hp >> 63;
+				hn_carry = hn >> 63;
+			}
+			else {
+				hp_carry = (hp & last) ? 1 : 0;
+				hn_carry = (hn & last) ? 1 : 0;
+			}
+			hp = (hp << 1) | hp_in;
+			hn = (hn << 1) | hn_in;
+			vp[w] = hn | ~(d0 | hp);
+			vn[w] = hp & d0;
+		}
+		dist += static_cast<int>(hp_carry) - static_cast<int>(hn_carry);
+	}
+	return dist;
+}
+
+int levenshteinBitParallel(const std::string& a, const std::string& b) {
+	const std::string& pattern = (a.size() <= b.size()) ? a : b;
+	const std::string& text = (a.size() <= b.size()) ? b : a;
+	if (pattern.empty())
+		return static_cast<int>(text.size());
+	if (pattern.size() <= 64)
+		return levenshteinBitParallel64(pattern, text);
+	return levenshteinBitParallelBlock(pattern, text);
+}
+
+//  Ÿ scorer å
+// Policy::Query  query غ ۾( ), Policy::similar  ĺ ϳ  
+//  å ø ڷ Ƿ Ÿ Ŀ, threshold ,  ᰡ ĺ  ȿ ζε
+
+// ü DP  å (LevenshteinScorer  )
+struct LevenshteinPolicy {
+	static constexpr int kBigramsPerEdit = 2;
+
+	struct Query {
+		const std::string& text;
+		KeywordSketch sketch;
+
+		explicit Query(const std::string& query) : text(query) {
+			buildSketch(query, sketch);
+		}
+	};
+
+	static int distance(Query& query, const Node2& candidate, int maxDist) {
+		return levenshteinBounded(candidate.name.text(), query.text, maxDist);
+	}
+};
+
+// Ʈ  å
+// ĺ 64 ϸ intern ̺ profile ״  ,
+// ƴϸ query Peq     ĺ 
+struct BitParallelPolicy {
+	static constexpr int kBigramsPerEdit = 2;
+
+	struct Query {
+		const std::string& text;
+		KeywordSketch sketch;
+		uint64_t peq[256];
+		bool peqReady = false;
+
+		explicit Query(const std::string& query) : text(query) {
+			buildSketch(query, sketch);
+		}
+	};
+
+	static int distance(Query& query, const Node2& candidate, int maxDist) {
+		const CharRange name = candidate.name.text();
+		const MatchProfile& profile = candidate.name.profile();
+		if (profile.hasPeq)
+			return myersDistanceProfileTrimmed(profile, name, query.text, maxDist);
+		if (query.text.size() <= 64) {
+			if (!query.peqReady) {
+				buildPeq64(query.text, query.peq);
+				query.peqReady = true;
+			}
+			const uint64_t* peq = query.peq;
+			return myersDistance64([peq](unsigned char c) { return peq[c]; }, query.text.size(), name, maxDist);
+		}
+		return levenshteinBounded(name, query.text, maxDist);
+	}
+
+	// intern  ĺ (profile Ƿ query Peq  )
+	static int distance(Query& query, const std::string& name, int maxDist) {
+		if (query.text.size() <= 64) {
+			if (!query.peqReady) {
+				buildPeq64(query.text, query.peq);
+				query.peqReady = true;
+			}
+			const uint64_t* peq = query.peq;
+			return myersDistance64([peq](unsigned char c) { return peq[c]; }, query.text.size(), name, maxDist);
+		}
+		return levenshteinBounded(name, query.text, maxDist);
+	}
+};
+
+// å ø ڷ ޴  Ű Ž  ( ȣ )
+//  ڿ/ ڿ/ ˻  óϰ, å Ÿ Ŀθ 
+// (Policy::kBigramsPerEdit: q-gram ѿ  1ȸ ߸  ִ bigram )
+template <typename Policy>
+struct SimilarityEngine {
+	// ĺ Ÿ (maxDist  maxDist + 1)
+	static int boundedDistance(typename Policy::Query& query, const Node2& candidate, int maxDist) {
+		return boundedDistance(query, candidate, candidate.name.size(), maxDist);
+	}
+
+	// ̸ ̸ ˰ ִ ĺ (   ),  ѿ ɸ Ű ǥ  
+	static int boundedDistance(typename Policy::Query& query, const Node2& candidate, size_t length, int maxDist) {
+		const std::string& text = query.text;
+		if (rejectedByLength(static_cast<int>(length), static_cast<int>(text.size()), maxDist))
+			return maxDist + 1;
+
+		const CharRange name = candidate.name.text();
+		if (name == text)
+			return 0;
+		if (name.empty() || text.empty())
+			return std::min(static_cast<int>(name.size() + text.size()), maxDist + 1);
+		if (!passesPrefilters(candidate.name.profile().sketch, query.sketch, maxDist, Policy::kBigramsPerEdit))
+			return maxDist + 1;
+		return Policy::distance(query, candidate, maxDist);
+	}
+
+	// intern  ڿ ĺ (similer  ܰ 񱳿, ĺ sketch ̶ )
+	static int boundedDistance(typename Policy::Query& query, const std::string& candidate, int maxDist) {
+		const std::string& text = query.text;
+		if (rejectedByLength(static_cast<int>(candidate.size()), static_cast<int>(text.size()), maxDist))
+			return maxDist + 1;
+		if (candidate == text)
+			return 0;
+		if (candidate.empty() || text.empty())
+			return std::min(static_cast<int>(candidate.size() + text.size()), maxDist + 1);
+		KeywordSketch sketch;
+		buildSketch(candidate, sketch);
+		if (!passesPrefilters(sketch, query.sketch, maxDist, Policy::kBigramsPerEdit))
+			return maxDist + 1;
+		return Policy::distance(query, candidate, maxDist);
+	}
+
+	template <typename Candidate>
+	static bool similar(typename Policy::Query& query, const Candidate& candidate, int threshold) {
+		const int max_len = static_cast<int>(std::max<size_t>(candidateSize(candidate), query.text.size()));
+		if (max_len == 0)
+			return 100 >= threshold;
+		const int max_dist = maxDistanceFor(max_len, threshold);
+		return max_dist >= 0 && boundedDistance(query, candidate, max_dist) <= max_dist;
+	}
+
+	static size_t candidateSize(const Node2& candidate) { return candidate.name.size(); }
+	static size_t candidateSize(const std::string& candidate) { return candidate.size(); }
+
+	static bool similar(typename Policy::Query& query, const Node2& candidate, size_t length, int threshold) {
+		const int max_len = static_cast<int>(std::max(length, query.text.size()));
+		if (max_len == 0)
+			return 100 >= threshold;
+		const int max_dist = maxDistanceFor(max_len, threshold);
+		return max_dist >= 0 && boundedDistance(query, candidate, length, max_dist) <= max_dist;
+	}
+
+	//    Բ  (ؽ / ̴   а, Ű ǥ    ĺ )
+	// verdicts ĺ ؽ÷   ã(lookup)     ޸ (findSimilarIndex RankListVerdicts)
+	template <typename Verdicts>
+	static int findFirstSimilar(typename Policy::Query& query, const std::vector<Node2>& candidates,
+		const RankColumns& columns, int threshold, Verdicts& verdicts) {
+		for (size_t i = 0; i < candidates.size(); ++i) {
+			const uint64_t hash = columns.hashes[i];
+			bool found;
+			if (!verdicts.lookup(hash, found)) {
+				found = similar(query, candidates[i], columns.lengths[i], threshold);
+				verdicts.store(hash, found);
+			}
+			if (found)
+				return static_cast<int>(i);
+		}
+		return -1;
+	}
+
+	static int findFirstSimilar(const std::string& query, const std::vector<Node2>& candidates, int threshold) {
+		typename Policy::Query prepared(query);
+		for (size_t i = 0; i < candidates.size(); ++i) {
+			if (similar(prepared, candidates[i], threshold))
+				return static_cast<int>(i);
+		}
+		return -1;
+	}
+
+	//   k nearest 
+	// ̹ k á  k°  Ѿ ϹǷ    Ÿ ٿ Ž
+	static void findNearest(const std::string& query, const std::vector<Node2>& candidates,
+		size_t k, int threshold, std::vector<SimilarKeyword>& nearest) {
+		typename Policy::Query prepared(query);
+		for (const Node2& candidate : candidates) {
+			const int max_len = static_cast<int>(std::max<size_t>(candidate.name.size(), query.size()));
+			const int floor_score = (nearest.size() < k) ? threshold : nearest.back().score + 1;
+			if (max_len == 0) {
+				if (100 >= floor_score)
+					insertNearest(nearest, k, candidate.name.str(), 100);
+				continue;
+			}
+			const int max_dist = maxDistanceFor(max_len, floor_score);
+			if (max_dist < 0)
+				continue;
+			const int dist = boundedDistance(prepared, candidate, max_dist);
+			if (dist <= max_dist)
+				insertNearest(nearest, k, candidate.name.str(), scoreFromDistance(dist, max_len));
+		}
+	}
+};
+
+// Ʈ  Ÿ     (LevenshteinScorer  )
+class BitParallelScorer : public ISimilarityScorer {
+public:
+	int score(const std::string& string1, const std::string& string2) const override {
+		if (string1.empty() && string2.empty())
+			return 100;
+		if (string1.empty() || string2.empty())
+			return 1;
+
+		int dist = levenshteinBitParallel(string1, string2);
+		int max_len = std::max(string1.length(), string2.length());
+		return scoreFromDistance(dist, max_len);
+	}
+
+	bool isSimilar(const std::string& string1, const std::string& string2, int threshold) const override;
+	int findFirstSimilar(const std::string& query, const std::vector<Node2>& candidates, int threshold) const override;
+	void findNearest(const std::string& query, const std::vector<Node2>& candidates,
+		size_t k, int threshold, std::vector<SimilarKeyword>& nearest) const override;
+};
+
+// ݴ밢(anti-diagonal)  SIMD Ÿ Ÿ
+// d[i][j] k = i + j 밢 ϸ  밢    16Ʈ lane  ó 
+//   cur[i] = min(prev[i - 1], prev[i], prev2[i - 1] - (a[i - 1] == b[j - 1])) + 1
+// b  ξ(rb) i   a, b   ޸𸮷  
+enum class SimdLevel { Scalar, Sse41, Avx2, Avx512 };
+
+using DiagonalKernel = void(*)(const int16_t* prev2, const int16_t* prev, int16_t* cur,
+	const int16_t* a16, const int16_t* rb16, int i_lo, int i_hi);
+
+// 16Ʈ lane   ִ ִ 
+const size_t kMaxSimdLen = 32000;
+
+void diagonalScalar(const int16_t* prev2, const int16_t* prev, int16_t* cur,
+	const int16_t* a16, const int16_t* rb16, int i_lo, int i_hi) {
+	for (int i = i_lo; i <= i_hi; ++i) {
+		int v = std::min(prev[i - 1], prev[i]);
+		int diag = prev2[i - 1] - (a16[i - 1] == rb16[i] ? 1 : 0);
+		cur[i] = static_cast<int16_t>(std::min(v, diag) + 1);
+	}
+}
+
+#ifdef FIX_KEYWORD_X86
+TARGET_ISA("sse4.1")
+void diagonalSse41(const int16_t* prev2, const int16_t* prev, int16_t* cur,
+	const int16_t* a16, const int16_t* rb16, int i_lo, int i_hi) {
+	const __m128i one = _mm_set1_epi16(1);
+	int i = i_lo;
+	for (; i + 7 <= i_hi; i += 8) {
+		__m128i up = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev + i - 1));
+		__m128i left = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev + i));
+		__m128i diag = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev2 + i - 1));
+		__m128i ca = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a16 + i - 1));
+		__m128i cb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rb16 + i));
+		diag = _mm_add_epi16(diag, _mm_cmpeq_epi16(ca, cb)); //  -1
+		__m128i v = _mm_min_epi16(_mm_min_epi16(up, left), diag);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(cur + i), _mm_add_epi16(v, one));
+	}
+	diagonalScalar(prev2, prev, cur, a16, rb16, i, i_hi);
+}
+
+TARGET_ISA("avx2")
+void diagonalAvx2(const int16_t* prev2, const int16_t* prev, int16_t* cur,
+	const int16_t* a16, const int16_t* rb16, int i_lo, int i_hi) {
+	const __m256i one = _mm256_set1_epi16(1);
+	int i = i_lo;
+	for (; i + 15 <= i_hi; i += 16) {
+		__m256i up = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev + i - 1));
+		__m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev + i));
+		__m256i diag = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev2 + i - 1));
+		__m256i ca = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a16 + i - 1));
+		__m256i cb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rb16 + i));
+		diag = _mm256_add_epi16(diag, _mm256_cmpeq_epi16(ca, cb));
+		__m256i v = _mm256_min_epi16(_mm256_min_epi16(up, left), diag);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(cur + i), _mm256_add_epi16(v, one));
+	}
+	diagonalScalar(prev2, prev, cur, a16, rb16, i, i_hi);
+}
+
+TARGET_ISA("avx512f,avx512bw")
+void diagonalAvx512(const int16_t* prev2, const int16_t* prev, int16_t* cur,
+	const int16_t* a16, const int16_t* rb16, int i_lo, int i_hi) {
+	const __m512i one = _mm512_set1_epi16(1);
+	int i = i_lo;
+	for (; i + 31 <= i_hi; i += 32) {
+		__m512i up = _mm512_loadu_si512(prev + i - 1);
+		__m512i left = _mm512_loadu_si512(prev + i);
+		__m512i diag = _mm512_loadu_si512(prev2 + i - 1);
+		__m512i ca = _mm512_loadu_si512(a16 + i - 1);
+		__m512i cb = _mm512_loadu_si512(rb16 + i);
+		__mmask32 eq = _mm512_cmpeq_epi16_mask(ca, cb);
+		diag = _mm512_mask_sub_epi16(diag, eq, diag, one);
+		__m512i v = _mm512_min_epi16(_mm512_min_epi16(up, left), diag);
+		_mm512_storeu_si512(cur + i, _mm512_add_epi16(v, one));
+	}
+	diagonalScalar(prev2, prev, cur, a16, rb16, i, i_hi);
+}
+#endif
+
+// cpuid   ɾ  Ȯ
+SimdLevel detectSimdLevel() {
+#ifdef FIX_KEYWORD_X86
+	bool sse41 = false, avx2 = false, avx512 = false;
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	const int max_leaf = info[0];
+	__cpuid(info, 1);
+	sse41 = (info[2] & (1 << 19)) != 0;
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+	if (osxsave && avx && max_leaf >= 7) {
+		const unsigned long long xcr0 = _xgetbv(0);
+		__cpuidex(info, 7, 0);
+		avx2 = (xcr0 & 0x6) == 0x6 && (info[1] & (1 << 5)) != 0;
+		avx512 = (xcr0 & 0xE6) == 0xE6 && (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0;
+	}
+#else
+	__builtin_cpu_init();
+	sse41 = __builtin_cpu_supports("sse4.1");
+	avx2 = __builtin_cpu_supports("avx2");
+	avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+	if (avx512) return SimdLevel::Avx512;
+	if (avx2) return SimdLevel::Avx2;
+	if (sse41) return SimdLevel::Sse41;
+#endif
+	return SimdLevel::Scalar;
+}
+
+DiagonalKernel diagonalKernelFor(SimdLevel level) {
+#ifdef FIX_KEYWORD_X86
+	switch (level) {
+	case SimdLevel::Avx512: return diagonalAvx512;
+	case SimdLevel::Avx2: return diagonalAvx2;
+	case SimdLevel::Sse41: return diagonalSse41;
+	default: break;
+	}
+#endif
+	return diagonalScalar;
+}
+
+//     CPU ȮϿ Ŀ 
+const SimdLevel g_simdLevel = detectSimdLevel();
+const DiagonalKernel g_diagonalKernel = diagonalKernelFor(g_simdLevel);
+
+int levenshteinAntiDiagonal(const std::string& a, const std::string& b, DiagonalKernel kernel) {
+	const int len_a = static_cast<int>(a.size());
+	const int len_b = static_cast<int>(b.size());
+	if (len_a == 0 || len_b == 0)
+		return len_a + len_b;
+	if (a.size() > kMaxSimdLen || b.size() > kMaxSimdLen)
+		return levenshtein(a, b);
+
+	// 밢 3 +  迭 2 庰 ۿ ġ
+	thread_local std::vector<int16_t> scratch;
+	const size_t diag_len = len_a + 1;
+	const size_t need = 3 * diag_len + len_a + len_b;
+	if (scratch.size() < need)
+		scratch.resize(need);
+
+	int16_t* prev2 = scratch.data();
+	int16_t* prev = prev2 + diag_len;
+	int16_t* cur = prev + diag_len;
+	int16_t* a16 = cur + diag_len;
+	int16_t* rb = a16 + len_a;
+
+	for (int i = 0; i < len_a; ++i) a16[i] = static_cast<unsigned char>(a[i]);
+	for (int t = 0; t < len_b; ++t) rb[t] = static_cast<unsigned char>(b[len_b - 1 - t]);
+
+	prev[0] = 0; // k = 0
+	for (int k = 1; k <= len_a + len_b; ++k) {
+		// : d[0][k] = k, d[k][0] = k
+		if (k <= len_b) cur[0] = static_cast<int16_t>(k);
+		if (k <= len_a) cur[k] = static_cast<int16_t>(k);
+
+		const int i_lo = std::max(1, k - len_b);
+		const int i_hi = std::min(len_a, k - 1);
+		if (i_lo <= i_hi)
+			kernel(prev2, prev, cur, a16, rb + (len_b - k), i_lo, i_hi);
+
+		int16_t* tmp = prev2;
+		prev2 = prev;
+		prev = cur;
+		cur = tmp;
+	}
+	return prev[len_a];
+}
+
+// 64 ϴ Ʈ , ׺  ڿ SIMD 밢 Ŀ 
+int levenshteinSimd(const std::string& a, const std::string& b) {
+	if (std::min(a.size(), b.size()) <= 64)
+		return levenshteinBitParallel(a, b);
+	return levenshteinAntiDiagonal(a, b, g_diagonalKernel);
+}
+
+// SIMD Ÿ    
+class SimdScorer : public ISimilarityScorer {
+public:
+	int score(const std::string& string1, const std::string& string2) const override {
+		if (string1.empty() && string2.empty())
+			return 100;
+		if (string1.empty() || string2.empty())
+			return 1;
+
+		int dist = levenshteinSimd(string1, string2);
+		int max_len = std::max(string1.length(), string2.length());
+		return scoreFromDistance(dist, max_len);
+	}
+};
+
+//  ASCII  (16Ʈ ֻ Ʈ ˻)
+bool isAscii(const std::string& s) {
+	const char* p = s.data();
+	const size_t n = s.size();
+	size_t i = 0;
+#if defined(FIX_KEYWORD_X86) && (defined(_MSC_VER) || defined(__SSE2__))
+	for (; i + 16 <= n; i += 16) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+		if (_mm_movemask_epi8(v) != 0)
+			return false;
+	}
+#endif
+	for (; i < n; ++i) {
+		if (static_cast<unsigned char>(p[i]) & 0x80)
+			return false;
+	}
+	return true;
+}
+
+// UTF-8 -> ڵ Ʈ 迭
+// ߸ Ʈ 0xDC00 + byte  ٲپ  еǵ 
+void decodeUtf8(const std::string& s, std::vector<uint32_t>& out) {
+	out.clear();
+	const size_t n = s.size();
+	size_t i = 0;
+	while (i < n) {
+		unsigned char c = s[i];
+		int extra = (c < 0x80) ? 0 : ((c >> 5) == 0x6) ? 1 : ((c >> 4) == 0xE) ? 2 : ((c >> 3) == 0x1E) ? 3 : -1;
+		uint32_t cp = (extra == 0) ? c : (extra == 1) ? (c & 0x1F) : (extra == 2) ? (c & 0x0F) : (c & 0x07);
+		bool valid = extra >= 0 && i + extra < n;
+		for (int k = 1; valid && k <= extra; ++k) {
+			unsigned char cc = s[i + k];
+			if ((cc & 0xC0) != 0x80)
+				valid = false;
+			else
+				cp = (cp << 6) | (cc & 0x3F);
+		}
+		if (!valid) {
+			out.push_back(0xDC00 + c);
+			i += 1;
+			continue;
+		}
+		out.push_back(cp);
+		i += 1 + extra;
+	}
+}
+
+// ڵ Ʈ (64 ) Peq, 128ĭ open addressing
+const uint32_t kEmptyCodePoint = 0xFFFFFFFFu;
+
+struct CodePointPeq {
+	uint32_t keys[128];
+	uint64_t masks[128];
+
+	explicit CodePointPeq(const std::vector<uint32_t>& pattern) {
+		std::fill(keys, keys + 128, kEmptyCodePoint);
+		std::fill(masks, masks + 128, 0ull);
+		for (size_t i = 0; i < pattern.size(); ++i)
+			masks[insert(pattern[i])] |= 1ull << i;
+	}
+
+	size_t insert(uint32_t cp) {
+		size_t h = (cp * 2654435761u) >> 25;
+		while (keys[h] != kEmptyCodePoint && keys[h] != cp)
+			h = (h + 1) & 127;
+		keys[h] = cp;
+		return h;
+	}
+
+	uint64_t operator()(uint32_t cp) const {
+		size_t h = (cp * 2654435761u) >> 25;
+		while (keys[h] != kEmptyCodePoint) {
+			if (keys[h] == cp)
+				return masks[h];
+			h = (h + 1) & 127;
+		}
+		return 0;
+	}
+};
+
+// ڵ Ʈ  Ÿ (maxDist ʰ  maxDist + 1)
+int codePointDistance(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, int maxDist) {
+	const std::vector<uint32_t>& pattern = (a.size() <= b.size()) ? a : b;
+	const std::vector<uint32_t>& text = (a.size() <= b.size()) ? b : a;
+	if (pattern.empty())
+		return std::min(static_cast<int>(text.size()), maxDist + 1);
+	if (pattern.size() <= 64) {
+		CodePointPeq peq(pattern);
+		return std::min(myersDistance64(peq, pattern.size(), text, maxDist), maxDist + 1);
+	}
+	return levenshteinBounded(pattern, text, maxDist);
+}
+
+// UTF-8 ڵ Ʈ     (ѱ  ڸ Ʈ 3 ƴ 1ڷ )
+//   ASCII̸ ڵ  Ʈ  Ŀ ״ 
+class Utf8Scorer : public ISimilarityScorer {
+public:
+	int score(const std::string& string1, const std::string& string2) const override {
+		if (string1.empty() && string2.empty())
+			return 100;
+		if (string1.empty() || string2.empty())
+			return 1;
+
+		if (isAscii(string1) && isAscii(string2)) {
+			int dist = levenshteinBitParallel(string1, string2);
+			return scoreFromDistance(dist, std::max(string1.length(), string2.length()));
+		}
+
+		std::vector<uint32_t>& cp1 = buffer(0);
+		std::vector<uint32_t>& cp2 = buffer(1);
+		decodeUtf8(string1, cp1);
+		decodeUtf8(string2, cp2);
+		const int max_len = static_cast<int>(std::max(cp1.size(), cp2.size()));
+		return scoreFromDistance(codePointDistance(cp1, cp2, max_len), max_len);
+	}
+
+	bool isSimilar(const std::string& string1, const std::string& string2, int threshold) const override {
+		if (string1.empty() && string2.empty())
+			return 100 >= threshold;
+		if (string1.empty() || string2.empty())
+			return 1 >= threshold;
+
+		if (isAscii(string1) && isAscii(string2)) {
+			int max_dist = maxDistanceFor(std::max(string1.length(), string2.length()), threshold);
+			return max_dist >= 0 && levenshteinBounded(string1, string2, max_dist) <= max_dist;
+		}
+
+		std::vector<uint32_t>& cp1 = buffer(0);
+		std::vector<uint32_t>& cp2 = buffer(1);
+		decodeUtf8(string1, cp1);
+		decodeUtf8(string2, cp2);
+		int max_dist = maxDistanceFor(static_cast<int>(std::max(cp1.size(), cp2.size())), threshold);
+		return max_dist >= 0 && codePointDistance(cp1, cp2, max_dist) <= max_dist;
+	}
+
+private:
+	// 庰 ϴ ڵ 
+	static std::vector<uint32_t>& buffer(int index) {
+		thread_local std::vector<uint32_t> buffers[2];
+		return buffers[index];
+	}
+};
+
+// OSA(optimal string alignment) Ÿ:   ġ("bnaana")  1ȸ 
+// Ÿ ġ 2ȸ Ƿ  ġ Ÿ   
+//  κ ڿ    ʴ ѵ Damerau Ÿ
+
+// ü DP ( ุ )
+int osaDistance(const std::string& a, const std::string& b) {
+	const size_t len_a = a.size();
+	const size_t len_b = b.size();
+	std::vector<int> rows(3 * (len_b + 1));
+	int* prev2 = rows.data();
+	int* prev = prev2 + len_b + 1;
+	int* cur = prev + len_b + 1;
+
+	for (size_t j = 0; j <= len_b; ++j) prev[j] = j;
+
+	for (size_t i = 1; i <= len_a; ++i) {
+		cur[0] = i;
+		for (size_t j = 1; j <= len_b; ++j) {
+			int cost = (a[i - 1] == b[j - 1]) ? 0 : 1;
+			cur[j] = std::min({ prev[j] + 1, cur[j - 1] + 1, prev[j - 1] + cost });
+			if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1])
+				cur[j] = std::min(cur[j], prev2[j - 2] + 1);
+		}
+		std::swap(prev2, prev);
+		std::swap(prev, cur);
+	}
+	return prev[len_b];
+}
+
+// band(|i - j| <= maxDist) ä OSA Ÿ, maxDist  maxDist + 1
+// ġ  prev2[j - 2] + 1 prev[j - 1]   Ƿ  ּҰ  ᰡ ״ 
+int osaBoundedRaw(const char* a, int len_a, const char* b, int len_b, int maxDist) {
+	const int over = maxDist + 1;
+
+	if (maxDist < 0 || std::abs(len_a - len_b) > maxDist)
+		return over;
+
+	int stack_buf[3 * kStackRowLen];
+	int* prev2 = levenshteinRows(len_b + 1, stack_buf, 3);
+	int* prev = prev2 + len_b + 1;
+	int* cur = prev + len_b + 1;
+
+	for (int j = 0; j <= len_b; ++j) prev[j] = (j <= maxDist) ? j : over;
+
+	for (int i = 1; i <= len_a; ++i) {
+		const int j_lo = std::max(1, i - maxDist);
+		const int j_hi = std::min(len_b, i + maxDist);
+
+		cur[j_lo - 1] = (j_lo == 1 && i <= maxDist) ? i : over;
+		int row_min = cur[j_lo - 1];
+
+		for (int j = j_lo; j <= j_hi; ++j) {
+			int v;
+			if (a[i - 1] == b[j - 1])
+				v = prev[j - 1];
+			else
+				v = 1 + std::min({ prev[j], cur[j - 1], prev[j - 1] });
+			if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1])
+				v = std::min(v, prev2[j - 2] + 1);
+			if (v > over) v = over;
+			cur[j] = v;
+			if (v < row_min) row_min = v;
+		}
+		if (j_hi < len_b)
+			cur[j_hi + 1] = over;
+
+		if (row_min > maxDist)
+			return over;
+		std::swap(prev2, prev);
+		std::swap(prev, cur);
+	}
+	return std::min(prev[len_b], over);
+}
+
+// Ʈ  OSA (Hyyro 2003): Myers ŽĿ ġ  TR 
+// TR:   ġ ʾҴ ġ  (̹ ,  )  ġϴ ġ
+template <typename PeqLookup, typename Text>
+int osaDistance64(PeqLookup peq, size_t m, const Text& text, int maxDist) {
+	const uint64_t last = 1ull << (m - 1);
+	uint64_t vp = ~0ull;
+	uint64_t vn = 0;
+	uint64_t d0 = 0;
+	uint64_t pm_prev = 0;
+	int dist = static_cast<int>(m);
+	int remaining = static_cast<int>(text.size());
+
+	for (auto c : text) {
+		const uint64_t pm = peq(c);
+		const uint64_t tr = (((~d0) & pm) << 1) & pm_prev;
+		d0 = (((pm & vp) + vp) ^ vp) | pm | vn | tr;
+		uint64_t hp = vn | ~(d0 | vp);
+		uint64_t hn = d0 & vp;
+		if (hp & last) dist++;
+		if (hn & last) dist--;
+		hp = (hp << 1) | 1;
+		hn = hn << 1;
+		vp = hn | ~(d0 | hp);
+		vn = hp & d0;
+		pm_prev = pm;
+
+		if (dist - --remaining > maxDist)
+			return maxDist + 1;
+	}
+	return dist;
+}
+
+//  λ/̻縦 ߶  ª  64 ϸ Ʈ , ƴϸ band DP
+template <typename TextA, typename TextB>
+int osaBoundedText(const TextA& a, const TextB& b, int maxDist) {
+	const AffixTrim trim = trimCommonAffixes(a.data(), a.size(), b.data(), b.size());
+	const size_t cut = trim.prefix + trim.suffix;
+	CharRange ra = { a.data() + trim.prefix, a.data() + a.size() - trim.suffix };
+	CharRange rb = { b.data() + trim.prefix, b.data() + b.size() - trim.suffix };
+	if (ra.size() > rb.size())
+		std::swap(ra, rb);
+
+	const size_t m = ra.size();
+	if (m == 0)
+		return std::min(static_cast<int>(rb.size()), maxDist + 1);
+	if (m > 64)
+		return osaBoundedRaw(a.data() + trim.prefix, static_cast<int>(a.size() - cut),
+			b.data() + trim.prefix, static_cast<int>(b.size() - cut), maxDist);
+
+	uint64_t peq[256] = {};
+	for (size_t i = 0; i < m; ++i)
+		peq[static_cast<unsigned char>(ra.first[i])] |= 1ull << i;
+	return osaDistance64([&](unsigned char c) { return peq[c]; }, m, rb, maxDist);
+}
+
+int osaBounded(const std::string& a, const std::string& b, int maxDist) {
+	return osaBoundedText(a, b, maxDist);
+}
+
+// myersDistanceProfileTrimmed OSA  (intern ̺ profile  )
+template <typename Name, typename Text>
+int osaDistanceProfileTrimmed(const MatchProfile& profile, const Name& name, const Text& text, int maxDist) {
+	const AffixTrim trim = trimCommonAffixes(name.data(), name.size(), text.data(), text.size());
+	const size_t m = name.size() - trim.prefix - trim.suffix;
+	const CharRange rest = { text.data() + trim.prefix, text.data() + text.size() - trim.suffix };
+	if (m == 0)
+		return std::min(static_cast<int>(rest.size()), maxDist + 1);
+
+	const unsigned shift = static_cast<unsigned>(trim.prefix);
+	const uint64_t keep = (m == 64) ? ~0ull : ((1ull << m) - 1);
+	return osaDistance64([&](unsigned char c) { return (profile.masks[profile.slot[c]] >> shift) & keep; },
+		m, rest, maxDist);
+}
+
+// OSA å (ġ 1ȸ  1ȸ )
+// ġ   ٲ Ƿ /׷  ״, bigram  3
+struct OsaPolicy {
+	static constexpr int kBigramsPerEdit = 3;
+
+	struct Query {
+		const std::string& text;
+		KeywordSketch sketch;
+
+		explicit Query(const std::string& query) : text(query) {
+			buildSketch(query, sketch);
+		}
+	};
+
+	static int distance(Query& query, const Node2& candidate, int maxDist) {
+		const CharRange name = candidate.name.text();
+		const MatchProfile& profile = candidate.name.profile();
+		if (profile.hasPeq)
+			return osaDistanceProfileTrimmed(profile, name, query.text, maxDist);
+		return osaBoundedText(name, query.text, maxDist);
+	}
+
+	static int distance(Query& query, const std::string& name, int maxDist) {
+		return osaBounded(name, query.text, maxDist);
+	}
+};
+
+class OsaScorer : public ISimilarityScorer {
+public:
+	int score(const std::string& string1, const std::string& string2) const override {
+		if (string1.empty() && string2.empty())
+			return 100;
+		if (string1.empty() || string2.empty())
+			return 1;
+
+		int max_len = std::max(string1.length(), string2.length());
+		return scoreFromDistance(osaBounded(string1, string2, max_len), max_len);
+	}
+
+	bool isSimilar(const std::string& string1, const std::string& string2, int threshold) const override {
+		OsaPolicy::Query query(string2);
+		return SimilarityEngine<OsaPolicy>::similar(query, string1, threshold);
+	}
+
+	int findFirstSimilar(const std::string& query, const std::vector<Node2>& candidates, int threshold) const override {
+		return SimilarityEngine<OsaPolicy>::findFirstSimilar(query, candidates, threshold);
+	}
+
+	void findNearest(const std::string& query, const std::vector<Node2>& candidates,
+		size_t k, int threshold, std::vector<SimilarKeyword>& nearest) const override {
+		SimilarityEngine<OsaPolicy>::findNearest(query, candidates, k, threshold, nearest);
+	}
+};
+
+//  Ÿ(maxDistanceFor) ȿ ϴ   ( /  / q-gram  ˻ )
+bool BitParallelScorer::isSimilar(const std::string& string1, const std::string& string2, int threshold) const {
+	BitParallelPolicy::Query query(string2);
+	return SimilarityEngine<BitParallelPolicy>::similar(query, string1, threshold);
+}
+
+int BitParallelScorer::findFirstSimilar(const std::string& query, const std::vector<Node2>& candidates, int threshold) const {
+	return SimilarityEngine<BitParallelPolicy>::findFirstSimilar(query, candidates, threshold);
+}
+
+void BitParallelScorer::findNearest(const std::string& query, const std::vector<Node2>& candidates,
+	size_t k, int threshold, std::vector<SimilarKeyword>& nearest) const {
+	SimilarityEngine<BitParallelPolicy>::findNearest(query, candidates, k, threshold, nearest);
+}
+
+// scorer ü 
+LevenshteinScorer g_levenshteinScorer;
+BitParallelScorer g_bitParallelScorer;
+SimdScorer g_simdScorer;
+Utf8Scorer g_utf8Scorer;
+OsaScorer g_osaScorer;
+
+// similer() ϴ scorer (ü )
+// ⺻  ׸ profile Ȱϴ Ʈ   (LevenshteinScorer  )
+const ISimilarityScorer* g_scorer = &g_bitParallelScorer;
+
+// ڿ 絵  Լ  Ÿ 
+using SimilarityFunc = int(*)(const std::string&, const std::string&);
+
+////  
+//int calcSimiler(const std::string& string1, const std::string& string2)
+//{
+//	if (string1.empty() && string2.empty())
+//		return 100;
+//	if (string1.empty() || string2.empty()) 
+//		return 1;
+//
+//	int dist = levenshtein(string1, string2);
+//	int max_len = std::max(string1.length(), string2.length());
+//	// 絵  (1.0:  , 0.0:  ٸ)
+//	double similarity = 1.0 - (double)dist / max_len;
+//
+//	int score = 1 + static_cast<int>(similarity * 99);
+//
+//	return score;
+//}
+//
+//// ߻ȭ Լ    ʱȭ
+//SimilarityFunc similarityFunc = calcSimiler;
+
+////  ȯ
+//bool similer(const std::string& string1, const std::string& string2) {
+//	int score = similarityFunc(string1, string2);
+//	return (score >= 80);
+//}
+
+//  ȯ
+// ֱ (query, ĺ)   ޸
+//  Ÿ ٲ   Ͽ ݺؼ   Ÿ  
+// ׸    (generation)   ȿ
+// addKeyword   ٲų scorer üǸ 븦 ÷ Ѳ ȿȭ
+constexpr int kRankListCount = 9;           // DayBest 7 + twoBest 2
+constexpr size_t kMemoEntries = 4096;       // 2 ŵ (direct-mapped)
+constexpr size_t kNegativeEntries = 256;    // ϴ, 2 ŵ
+
+struct SimilarityMemoEntry {
+	uint64_t query = 0;
+	uint64_t candidate = 0;
+	uint32_t generation = 0;                // 0:  ׸
+	uint8_t list = 0;
+	bool similar = false;
+};
+
+// "  generation 뿡  ׸ " 
+struct NegativeCacheEntry {
+	uint64_t query = 0;
+	uint32_t generation = 0;                // 0:  ׸
+};
+
+struct SimilarityMemoStats {
+	long long lookups = 0;
+	long long hits = 0;
+	long long misses = 0;
+	long long invalidations = 0;
+	long long negativeHits = 0;             //  ü Ž  Ƚ
+	long long negativeStores = 0;
+};
+
+SimilarityMemoEntry g_similarityMemo[kMemoEntries];
+NegativeCacheEntry g_negativeCache[kRankListCount][kNegativeEntries];
+SimilarityMemoStats g_similarityMemoStats;
+uint32_t g_listGeneration[kRankListCount] = { 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+// Ϻ  ȣ (  + point ),  ȸ view ȿ Ȯ / 
+//  ġ  Ȧ,  ¦
+std::atomic<uint64_t> g_rankVersion[kRankListCount] = {};
+
+// ٸ  纻 ٽ  ϴ  (bit: list_id, ó )
+//  (RankWriteBatch) ̸     , ̸ ٷ Խ (д  ִ ϸ)
+unsigned g_rankDirty = (1u << kRankListCount) - 1;
+int g_rankWriteBatch = 0;
+
+void publishRankSnapshots();
+
+void markRankDirty(int list_id) {
+	g_rankDirty |= 1u << list_id;
+	if (g_rankWriteBatch == 0)
+		publishRankSnapshots();
+}
+
+// updateKeywordBy  ó     ġ , ٲ      Խ
+class RankWriteBatch {
+public:
+	RankWriteBatch() { g_rankWriteBatch++; }
+	~RankWriteBatch() {
+		if (--g_rankWriteBatch == 0 && g_rankDirty != 0)
+			publishRankSnapshots();
+	}
+	RankWriteBatch(const RankWriteBatch&) = delete;
+	RankWriteBatch& operator=(const RankWriteBatch&) = delete;
+};
+
+void beginRankWrite(int list_id) {
+	g_rankVersion[list_id].fetch_add(1, std::memory_order_relaxed);
+}
+
+void endRankWrite(int list_id) {
+	g_rankVersion[list_id].fetch_add(1, std::memory_order_release);
+	markRankDirty(list_id);
+}
+
+// DayBest[0..6] -> 0..6, twoBest[0..1] -> 7..8,    -> -1 (޸  )
+int rankListId(const std::vector<Node2>& list) {
+	if (&list >= DayBest && &list < DayBest + 7)
+		return static_cast<int>(&list - DayBest);
+	if (&list >= twoBest && &list < twoBest + 2)
+		return 7 + static_cast<int>(&list - twoBest);
+	return -1;
+}
+
+void invalidateSimilarityMemo(int list_id) {
+	if (++g_listGeneration[list_id] == 0)
+		g_listGeneration[list_id] = 1;
+	g_similarityMemoStats.invalidations++;
+}
+
+SimilarityMemoEntry& similarityMemoSlot(uint64_t query, uint64_t candidate, int list_id) {
+	uint64_t h = (query ^ (candidate * 0x9E3779B97F4A7C15ull)) + static_cast<uint64_t>(list_id);
+	h ^= h >> 29;
+	return g_similarityMemo[h & (kMemoEntries - 1)];
+}
+
+//  Ϻ keyword id ->  ġ(slot)  (Ϻ HIT ˻, K ϰ O(1))
+//  Ž open addressing, ĭ Ű ؽø  Ͽ ؽ  Ž/
+//  backward-shift óϿ tombstone  
+//  ġ  ׸ ִ ĭ ȣ(buckets_)  ξ, //  и ׸
+// Ž  ĭ slot ħ (insert / eraseSlot / move  ̵ ״  )
+struct RankIndexSlot {
+	uint64_t hash;
+	uint32_t id;                            // kNoKeyword:  ĭ
+	int32_t slot;
+};
+
+class RankIndex {
+public:
+	// id  ġ ( -1)
+	int find(uint32_t id, uint64_t hash) const {
+		if (slots_.empty())
+			return -1;
+		const size_t mask = slots_.size() - 1;
+		for (size_t i = hash & mask; slots_[i].id != kNoKeyword; i = (i + 1) & mask) {
+			if (slots_[i].id == id)
+				return slots_[i].slot;
+		}
+		return -1;
+	}
+
+	//  ߰,  ġ 
+	void assign(uint32_t id, uint64_t hash, int slot) {
+		if ((count_ + 1) * 2 > slots_.size())
+			grow();
+		const size_t mask = slots_.size() - 1;
+		size_t i = hash & mask;
+		while (slots_[i].id != kNoKeyword && slots_[i].id != id)
+			i = (i + 1) & mask;
+		if (slots_[i].id == kNoKeyword)
+			count_++;
+		slots_[i] = { hash, id, slot };
+		if (static_cast<size_t>(slot) >= buckets_.size())
+			buckets_.resize(slot + 1);
+		buckets_[slot] = static_cast<uint32_t>(i);
+	}
+
+	void erase(uint32_t id, uint64_t hash) {
+		if (slots_.empty())
+			return;
+		const size_t mask = slots_.size() - 1;
+		size_t hole = hash & mask;
+		while (slots_[hole].id != id) {
+			if (slots_[hole].id == kNoKeyword)
+				return;
+			hole = (hole + 1) & mask;
+		}
+		for (size_t j = (hole + 1) & mask; slots_[j].id != kNoKeyword; j = (j + 1) & mask) {
+			const size_t home = slots_[j].hash & mask;
+			const bool stays = (hole <= j) ? (hole < home && home <= j) : (hole < home || home <= j);
+			if (!stays) {
+				slots_[hole] = slots_[j];
+				buckets_[slots_[hole].slot] = static_cast<uint32_t>(hole);
+				hole = j;
+			}
+		}
+		slots_[hole].id = kNoKeyword;
+		count_--;
+	}
+
+	void rebuild(const std::vector<Node2>& list) {
+		slots_.assign(slots_.size(), { 0, kNoKeyword, -1 });
+		count_ = 0;
+		buckets_.assign(list.size(), 0);
+		for (size_t i = 0; i < list.size(); ++i)
+			assign(list[i].name.id(), list[i].name.hash(), static_cast<int>(i));
+	}
+
+	//  at ׸   (   ĭ и)
+	void insert(const std::vector<Node2>& list, size_t at) {
+		buckets_.insert(buckets_.begin() + at, 0);
+		renumber(at + 1, list.size());
+		assign(list[at].name.id(), list[at].name.hash(), static_cast<int>(at));
+	}
+
+	// erase()  ׸ ִ  ġ  (   ĭ )
+	void eraseSlot(size_t slot) {
+		buckets_.erase(buckets_.begin() + slot);
+		renumber(slot, buckets_.size());
+	}
+
+	//  from ׸ to(from ̻)     ĭ  , to ٲ ׸
+	// (from ׸ erase()  to  Ű尡 )
+	void move(const std::vector<Node2>& list, size_t from, size_t to) {
+		std::rotate(buckets_.begin() + from, buckets_.begin() + from + 1, buckets_.begin() + to + 1);
+		renumber(from, to);
+		assign(list[to].name.id(), list[to].name.hash(), static_cast<int>(to));
+	}
+
+	size_t size() const { return count_; }
+
+private:
+	//  [first, last)  ĭ  ġ 
+	void renumber(size_t first, size_t last) {
+		for (size_t i = first; i < last; ++i)
+			slots_[buckets_[i]].slot = static_cast<int32_t>(i);
+	}
+
+	void grow() {
+		std::vector<RankIndexSlot> old;
+		old.swap(slots_);
+		slots_.assign(std::max<size_t>(16, old.size() * 2), { 0, kNoKeyword, -1 });
+		count_ = 0;
+		for (const RankIndexSlot& entry : old) {
+			if (entry.id != kNoKeyword)
+				assign(entry.id, entry.hash, entry.slot);
+		}
+	}
+
+	std::vector<RankIndexSlot> slots_;
+	std::vector<uint32_t> buckets_;          //  ġ -> ĭ ȣ
+	size_t count_ = 0;
+};
+
+RankIndex g_rankIndex[kRankListCount];
+// Ϻ / ϡָ heavy hitter  (  ڿ ִ )
+//   /   HIT(Ϻ HIT,  HIT ã Ű, ̽ Է Ű) 
+// DayBest / twoBest   top-K materialized view  ( top-K  )
+//     (HIT ġ, point): ġ ũų,  point(UZ / Decay ) ū 
+//   HIT    Ű常  ڰ ȮϹǷ   Ű ġ ׻  ּڰ 
+//    ǥ  point  ״ (hits ׸   Բ )
+CountMinSketch g_heavyHitters[kRankListCount];
+RankColumns g_rankColumns[kRankListCount] = {
+	RankColumns(&g_heavyHitters[0]), RankColumns(&g_heavyHitters[1]), RankColumns(&g_heavyHitters[2]),
+	RankColumns(&g_heavyHitters[3]), RankColumns(&g_heavyHitters[4]), RankColumns(&g_heavyHitters[5]),
+	RankColumns(&g_heavyHitters[6]), RankColumns(&g_heavyHitters[7]), RankColumns(&g_heavyHitters[8])
+};
+
+//  Ͽ keyword id ġ ( -1),  ȸ  
+//     ϹǷ,   ģ   ʴ ߸ ׸  
+int findRankSlot(const std::vector<Node2>& list, uint32_t keyword_id) {
+	if (keyword_id == kNoKeyword)
+		return -1;
+	const int list_id = rankListId(list);
+	if (list_id < 0) {
+		for (size_t i = 0; i < list.size(); ++i) {
+			if (list[i].name.id() == keyword_id)
+				return static_cast<int>(i);
+		}
+		return -1;
+	}
+	const int slot = g_rankIndex[list_id].find(keyword_id, g_keywords.hash(keyword_id));
+	if (slot < 0 || static_cast<size_t>(slot) >= list.size() || list[slot].name.id() != keyword_id)
+		return -1;
+	return slot;
+}
+
+// addKeyword ġ ʰ  ٲ  ޸  ٽ 
+// ̹ ٲ ڿ ȣǹǷ  ȣ ¦Ȧ  ä 2 
+void rankListChanged(int list_id, const std::vector<Node2>& list) {
+	invalidateSimilarityMemo(list_id);
+	g_rankIndex[list_id].rebuild(list);
+	g_rankColumns[list_id].rebuild(list);
+	g_rankVersion[list_id].fetch_add(2, std::memory_order_release);
+	markRankDirty(list_id);
+}
+
+void setSimilarityScorer(const ISimilarityScorer* scorer) {
+	g_scorer = scorer;
+	for (int list_id = 0; list_id < kRankListCount; ++list_id)
+		invalidateSimilarityMemo(list_id);
+}
+
+void printSimilarityMemoStats(std::ostream& out) {
+	const SimilarityMemoStats& st = g_similarityMemoStats;
+	double total = st.lookups ? static_cast<double>(st.lookups) : 1.0;
+	out << "memo lookups=" << st.lookups
+		<< " hits=" << st.hits << " (" << 100.0 * st.hits / total << "%)"
+		<< " misses=" << st.misses
+		<< " invalidations=" << st.invalidations
+		<< " negativeHits=" << st.negativeHits
+		<< " negativeStores=" << st.negativeStores << "\n";
+}
+
+bool similer(const std::string& string1, const std::string& string2) {
+	return g_scorer->isSimilar(string1, string2, SIMILAR_THRESHOLD);
+}
+
+//  query DayBest / twoBest  ϳ  ĺ  ޸ (  ׸ )
+struct RankListVerdicts {
+	uint64_t query;
+	uint32_t generation;
+	int list_id;
+
+	bool lookup(uint64_t candidate, bool& similar) const {
+		const SimilarityMemoEntry& entry = similarityMemoSlot(query, candidate, list_id);
+		g_similarityMemoStats.lookups++;
+		if (entry.generation == generation && entry.list == list_id
+			&& entry.query == query && entry.candidate == candidate) {
+			g_similarityMemoStats.hits++;
+			similar = entry.similar;
+			return true;
+		}
+		g_similarityMemoStats.misses++;
+		return false;
+	}
+
+	void store(uint64_t candidate, bool similar) const {
+		SimilarityMemoEntry& entry = similarityMemoSlot(query, candidate, list_id);
+		entry.query = query;
+		entry.candidate = candidate;
+		entry.generation = generation;
+		entry.list = static_cast<uint8_t>(list_id);
+		entry.similar = similar;
+	}
+};
+
+//  뿡 ̹  keyword ٷ -1, ƴϸ scan(verdicts)  Ȱ и  ĳÿ 
+template <typename Scan>
+int findSimilarMemoized(const std::string& keyword, int list_id, Scan scan) {
+	const uint64_t query_hash = hashKeyword(keyword);
+	const uint32_t generation = g_listGeneration[list_id];
+	NegativeCacheEntry& negative = g_negativeCache[list_id][(query_hash ^ (query_hash >> 32)) & (kNegativeEntries - 1)];
+	if (negative.generation == generation && negative.query == query_hash) {
+		g_similarityMemoStats.negativeHits++;
+		return -1;
+	}
+
+	RankListVerdicts verdicts{ query_hash, generation, list_id };
+	const int found = scan(verdicts);
+	if (found < 0) {
+		negative.query = query_hash;
+		negative.generation = generation;
+		g_similarityMemoStats.negativeStores++;
+	}
+	return found;
+}
+
+//  Ͽ keyword  ù ° ׸ index ( -1)
+// ⺻ scorer OSA scorer ø  ٷ óϰ,   ü scorer  ȣ ó
+// DayBest / twoBest   (RankColumns)   ĺ  ޸𿡼  ã
+int findSimilarIndex(const std::string& keyword, const std::vector<Node2>& list) {
+	const int list_id = rankListId(list);
+	if (g_scorer == &g_bitParallelScorer) {
+		if (list_id < 0)
+			return SimilarityEngine<BitParallelPolicy>::findFirstSimilar(keyword, list, SIMILAR_THRESHOLD);
+		BitParallelPolicy::Query prepared(keyword);
+		return findSimilarMemoized(keyword, list_id, [&](RankListVerdicts& verdicts) {
+			return SimilarityEngine<BitParallelPolicy>::findFirstSimilar(prepared, list, g_rankColumns[list_id],
+				SIMILAR_THRESHOLD, verdicts);
+		});
+	}
+	if (g_scorer == &g_osaScorer) {
+		if (list_id < 0)
+			return SimilarityEngine<OsaPolicy>::findFirstSimilar(keyword, list, SIMILAR_THRESHOLD);
+		OsaPolicy::Query prepared(keyword);
+		return findSimilarMemoized(keyword, list_id, [&](RankListVerdicts& verdicts) {
+			return SimilarityEngine<OsaPolicy>::findFirstSimilar(prepared, list, g_rankColumns[list_id],
+				SIMILAR_THRESHOLD, verdicts);
+		});
+	}
+
+	if (list_id < 0)
+		return g_scorer->findFirstSimilar(keyword, list, SIMILAR_THRESHOLD);
+	return findSimilarMemoized(keyword, list_id, [&](RankListVerdicts& verdicts) {
+		const RankColumns& columns = g_rankColumns[list_id];
+		for (size_t i = 0; i < list.size(); ++i) {
+			bool similar;
+			if (!verdicts.lookup(columns.hashes[i], similar)) {
+				similar = g_scorer->isSimilar(list[i].name.str(), keyword, SIMILAR_THRESHOLD);
+				verdicts.store(columns.hashes[i], similar);
+			}
+			if (similar)
+				return static_cast<int>(i);
+		}
+		return -1;
+	});
+}
+
+//bool similer(const std::string& string1, const std::string& string2) {
+//	int score = calcSimiler(string1, string2);
+//	return (score >= 80);
+//}
+
+void findNearestIn(const std::string& keyword, const std::vector<Node2>& list, size_t k, std::vector<SimilarKeyword>& nearest) {
+	if (g_scorer == &g_bitParallelScorer)
+		SimilarityEngine<BitParallelPolicy>::findNearest(keyword, list, k, SIMILAR_THRESHOLD, nearest);
+	else
+		g_scorer->findNearest(keyword, list, k, SIMILAR_THRESHOLD, nearest);
+}
+
+//  -> ε 
+map<string, int> dayToIndex = {
+	{"monday", 0}, {"tuesday", 1}, {"wednesday", 2},
+	{"thursday", 3}, {"friday", 4}, {"saturday", 5}, {"sunday", 6}
+};
+
+// ش  / ϡָ  Ͽ keyword   Ű k ( )
+// updateKeywordBy  HIT  ù °  Ѵ ׸ 
+vector<SimilarKeyword> findNearestKeywords(const string& keyword, const string& day, size_t k) {
+	vector<SimilarKeyword> nearest;
+	auto it = dayToIndex.find(day);
+	if (it == dayToIndex.end() || k == 0)
+		return nearest;
+
+	int day_index = it->second;
+	int weekend_index = (day_index <= 4) ? 0 : 1;
+	findNearestIn(keyword, DayBest[day_index], k, nearest);
+	findNearestIn(keyword, twoBest[weekend_index], k, nearest);
+	return nearest;
+}
+
+//   ũ ⺻ (  -DFIX_KEYWORD_RANK_CAPACITY=100  )
+#ifndef FIX_KEYWORD_RANK_CAPACITY
+#define FIX_KEYWORD_RANK_CAPACITY 10
+#endif
+constexpr size_t kDefaultRankCapacity = FIX_KEYWORD_RANK_CAPACITY;
+static_assert(kDefaultRankCapacity > 0, "  ũ 1 ̻");
+
+//   ũ (DayBest / twoBest , Ÿӿ setRankCapacity )
+size_t g_rankCapacity = kDefaultRankCapacity;
+
+std::vector<Node2>& rankList(int list_id) {
+	return (list_id < 7) ? DayBest[list_id] : twoBest[list_id - 7];
+}
+
+// point  ϸ ϰ  ġ ȯ (  -1)
+//  á   ׸( ) point Ŭ   ׸  
+//  point ̿ ߿  ׸ ڿ 
+// ġ Ž  Ž, ̵  ġ ª shift  
+int insertRanked(std::vector<Node2>& list, size_t capacity, const std::string& keyword, int point, RankIndex* index,
+	RankColumns* columns = nullptr) {
+	if (capacity == 0)
+		return -1;
+	auto pos = std::upper_bound(list.begin(), list.end(), point,
+		[](int value, const Node2& node) { return value < node.point; });
+
+	if (list.size() < capacity) {
+		const size_t at = static_cast<size_t>(pos - list.begin());
+		list.insert(pos, Node2{ keyword, point });
+		if (index)
+			index->insert(list, at);
+		if (columns)
+			columns->insert(list, at);
+		return static_cast<int>(at);
+	}
+
+	if (!(list[0].point < point))
+		return -1;
+	if (index)
+		index->erase(list[0].name.id(), list[0].name.hash());
+	//   ׸   ġ ձ  ĭ    ڸ  ׸
+	Node2 evicted = std::move(list[0]);
+	std::move(list.begin() + 1, pos, list.begin());
+	const size_t at = static_cast<size_t>(pos - list.begin()) - 1;
+	list[at] = Node2{ keyword, point };
+	if (index)
+		index->move(list, 0, at);
+	if (columns)
+		columns->move(list, 0, at);
+	return static_cast<int>(at);
+}
+
+// point  ׸ point ۰ų  ׸ ڷ ʿ ŭ ű  ġ ȯ
+//  point ̿   ׸ ڿ  (insertRanked  upper_bound Ģ)
+// ġ ̺ Ž, ̵    ĭ  (point ⸸ ϹǷ  ״)
+int raiseRanked(std::vector<Node2>& list, size_t slot, RankIndex* index, RankColumns* columns = nullptr) {
+	const int point = list[slot].point;
+	auto first = list.begin() + slot;
+	auto to = std::upper_bound(first + 1, list.end(), point,
+		[](int value, const Node2& node) { return value < node.point; });
+	if (to == first + 1) {
+		if (columns)
+			columns->assign(list, slot);
+		return static_cast<int>(slot);
+	}
+
+	Node2 raised = std::move(*first);
+	std::move(first + 1, to, first);
+	*(to - 1) = std::move(raised);
+	const size_t at = static_cast<size_t>(to - list.begin()) - 1;
+	if (index)
+		index->move(list, slot, at);
+	if (columns)
+		columns->move(list, slot, at);
+	return static_cast<int>(at);
+}
+
+//  
+// Legacy:  Ű UZ, HIT 10% , 2100000000  resetScore() ü 
+// Decay: ȸ ð    (ݰ g_halfLife )
+//    = sum(2^-(now - t_i) / halfLife)  forward decay · log  
+//   point = log2(sum(2^(t_i / halfLife))) * g_logScoreOne
+//    ׸   ð Ƿ ð 귯   ʰ,
+//       (decayedScore) ->  ü  ȭ 
+//    log   ĿǷ Ϻ (g_listLogBase)   int point ϰ,
+//        ʿϸ ű (currentPoint)
+enum class ScoreMode { Legacy, Decay };
+
+constexpr int kLogScoreOne = 1024;             // log2 1 شϴ Ҽ  ּڰ
+constexpr int kLogScoreMaxOne = 1 << 18;       // ִ (kLogHeadroom 64 ݰ ̻ )
+constexpr int kLogRebaseAt = 1 << 30;          //   point ⿡   ű
+constexpr int kLogHeadroom = 1 << 24;          //  ű   ð Ʒ  
+
+// halfLife  Ҽ 
+// kLogScoreOne ̻ halfLife   logScoreAt()  (ð 1ƽ = 1 ̻,  )
+// halfLife kLogScoreMaxOne      ( ƽ  point)
+constexpr int logScoreOneFor(long long halfLife) {
+	const long long ticks = (kLogScoreOne + halfLife - 1) / halfLife;
+	return static_cast<int>(std::min<long long>(halfLife * ticks, kLogScoreMaxOne));
+}
+
+ScoreMode g_scoreMode = ScoreMode::Legacy;
+long long g_scoreClock = 0;                     // Decay  ð (64Ʈ, ʱȭ )
+long long g_halfLife = 1000;
+int g_logScoreOne = logScoreOneFor(1000);      // log2 1 شϴ Ҽ  (halfLife )
+long long g_listLogBase[kRankListCount] = {};   // Ϻ log   (point =  log  - )
+
+// clock   HIT 1ȸ  log 
+long long logScoreAt(long long clock) {
+	return clock * g_logScoreOne / g_halfLife;
+}
+
+// log2(2^a + 2^b)
+int logAddScore(int a, int b) {
+	const int hi = std::max(a, b);
+	const int diff = hi - std::min(a, b);
+	if (diff >= 32 * g_logScoreOne)
+		return hi;
+	const double carry = std::log2(1.0 + std::exp2(-static_cast<double>(diff) / g_logScoreOne));
+	return static_cast<int>(std::min<long long>(hi + std::lround(carry * g_logScoreOne), 2100000000));
+}
+
+// list_id  point now    (HIT 1ȸ = 1.0)
+double decayedScore(int list_id, int point, long long now) {
+	const double base = static_cast<double>(logScoreAt(now) - g_listLogBase[list_id]);
+	return std::exp2((point - base) / g_logScoreOne);
+}
+
+
+//  slot ׸   и  ٽ ,  ϰ  
+void eraseRanked(std::vector<Node2>& list, size_t slot, RankIndex* index, RankColumns* columns) {
+	if (index)
+		index->erase(list[slot].name.id(), list[slot].name.hash());
+	list.erase(list.begin() + slot);
+	if (index)
+		index->eraseSlot(slot);
+	if (columns)
+		columns->erase(slot);
+}
+
+//     
+// Legacy: (hits, point)   ׸
+// Decay: point     ׸ (  ȿ point  =   ,
+//    HIT Ƚ  Ƿ   HIT Ű尡 ڸ  ʵ  )
+size_t evictionSlot(int list_id) {
+	if (g_scoreMode == ScoreMode::Decay)
+		return 0;
+	return g_rankColumns[list_id].lowestRanked();
+}
+
+// Ͽ  Ű  ó (hits:   HIT ġ)
+//  á  󺸴   (Legacy: (hits, point), Decay:  )  ׸ ,
+// point  ġ 
+bool admitKeyword(int list_id, const std::string& keyword, int point, uint32_t hits) {
+	std::vector<Node2>& list = rankList(list_id);
+	RankIndex* index = &g_rankIndex[list_id];
+	RankColumns* columns = &g_rankColumns[list_id];
+	if (g_rankCapacity == 0)
+		return false;
+
+	// Legacy   hits  Ⱦ ã
+	size_t lowest = 0;
+	if (list.size() >= g_rankCapacity) {
+		lowest = evictionSlot(list_id);
+		const uint32_t lowest_hits = (g_scoreMode == ScoreMode::Decay) ? hits : columns->hits[lowest];
+		if (!(lowest_hits < hits || (lowest_hits == hits && list[lowest].point < point)))
+			return false;
+	}
+	beginRankWrite(list_id);
+	if (list.size() >= g_rankCapacity)
+		eraseRanked(list, lowest, index, columns);
+	//  ġ hits  ࿡ ٽ Ƿ   ġ 
+	const int at = insertRanked(list, g_rankCapacity, keyword, point, index, columns);
+	endRankWrite(list_id);
+	invalidateSimilarityMemo(list_id);
+	return at >= 0;
+}
+
+// list_id ࿡ keyword HIT 1ȸ 
+// Ͽ   ׸ hits ߰ ( point ̹Ƿ ״),  point  õ
+// ȯ:   Ͽ  true
+bool recordRankHit(int list_id, const std::string& keyword, int point) {
+	std::vector<Node2>& list = rankList(list_id);
+	const uint32_t hits = g_heavyHitters[list_id].add(hashKeyword(keyword));
+	const int slot = findRankSlot(list, g_keywords.find(keyword));
+	if (slot < 0)
+		return admitKeyword(list_id, keyword, point, hits);
+	// hits     /  Ǵܿ ̰ (point ) ״̹Ƿ  ȣ Խô 
+	g_rankColumns[list_id].hits[slot] = hits;
+	return true;
+}
+
+//  ũ , ̴     (Legacy:  top-K, Decay:   top-K )
+void setRankCapacity(size_t capacity) {
+	g_rankCapacity = capacity;
+	for (int list_id = 0; list_id < kRankListCount; ++list_id) {
+		std::vector<Node2>& list = rankList(list_id);
+		//   capacityŭ  ξ    Ҵ 
+		list.reserve(capacity);
+		g_rankColumns[list_id].reserve(capacity);
+		if (list.size() > capacity) {
+			beginRankWrite(list_id);
+			while (list.size() > capacity)
+				eraseRanked(list, evictionSlot(list_id), &g_rankIndex[list_id], &g_rankColumns[list_id]);
+			rankListChanged(list_id, list);
+			endRankWrite(list_id);
+		}
+	}
+}
+
+void resetScore();
+int increaseNodePoint(int point);
+
+//   
+// resetScore() 븸 ø,      syncScoreGeneration() 
+unsigned g_scoreGeneration = 0;
+unsigned g_listScoreGeneration[kRankListCount] = {};
+
+// Ϻ HIT   
+int bumpPoint(int point, int now) {
+	if (g_scoreMode == ScoreMode::Decay)
+		return logAddScore(point, now);
+	return increaseNodePoint(point);
+}
+
+//   ,    ϰ   point ٽ ű
+//  HIT Ƚ   ̹Ƿ 
+void setScoreMode(ScoreMode mode, long long halfLife = 1000) {
+	g_scoreMode = mode;
+	g_halfLife = std::max(halfLife, 1LL);
+	g_logScoreOne = logScoreOneFor(g_halfLife);
+	for (CountMinSketch& tier : g_heavyHitters)
+		tier.clear();
+	if (mode == ScoreMode::Legacy) {
+		resetScore();
+		return;
+	}
+	//   ׸  ð HIT 1ȸ(  kLogHeadroom), Ʒ  ݾ 
+	// point RankIndex -1 "" Ƿ 0 ̻ 
+	for (int list_id = 0; list_id < kRankListCount; ++list_id) {
+		std::vector<Node2>& list = rankList(list_id);
+		beginRankWrite(list_id);
+		g_listLogBase[list_id] = logScoreAt(g_scoreClock) - kLogHeadroom;
+		for (size_t i = 0; i < list.size(); i++)
+			list[i].point = kLogHeadroom - static_cast<int>(list.size() - 1 - i);
+		rankListChanged(list_id, list);
+		endRankWrite(list_id);
+		g_listScoreGeneration[list_id] = g_scoreGeneration;
+	}
+}
+
+// list_id Ͽ   Ű point (Legacy: UZ, Decay:  ð HIT 1ȸ)
+// Decay 忡   point kLogRebaseAt   ϸ  ű
+//   簡 ٽ kLogHeadroom ǵ  ׸񿡼   Ƿ  ״,
+//   ׺  ׸ 0  (64 ݰ ̻ ̹Ƿ  δ ̹ 0 )
+int currentPoint(int list_id) {
+	if (g_scoreMode != ScoreMode::Decay)
+		return UZ;
+	long long now = logScoreAt(g_scoreClock) - g_listLogBase[list_id];
+	if (now >= kLogRebaseAt) {
+		std::vector<Node2>& list = rankList(list_id);
+		const long long shift = now - kLogHeadroom;
+		beginRankWrite(list_id);
+		for (Node2& node : list)
+			node.point = static_cast<int>(std::max<long long>(node.point - shift, 0));
+		g_listLogBase[list_id] += shift;
+		endRankWrite(list_id);
+		now -= shift;
+	}
+	return static_cast<int>(now);
+}
+
+//  аų ġ  ȣ,  resetScore()  ó ̸ point 1..n ٽ ű
+//  ൵  ȭ (point ó ٽ Ƿ HIT Ƚ   )
+//     ȣ⿡  ʰ     
+void syncScoreGeneration(int list_id) {
+	if (g_listScoreGeneration[list_id] == g_scoreGeneration)
+		return;
+	g_listScoreGeneration[list_id] = g_scoreGeneration;
+
+	std::vector<Node2>& list = rankList(list_id);
+	beginRankWrite(list_id);
+	int num = 1;
+	for (Node2& node : list)
+		node.point = num++;
+	endRankWrite(list_id);
+	g_heavyHitters[list_id].halve();
+}
+
+//  ȸ   ׸, ̸ intern Ҹ ״ Ŵ
+struct RankEntry {
+	CharRange name;
+	int point;
+};
+
+//   б  view ( , rank 0 1)
+//   Ƿ    ,   stale() false̸   ϰ 
+// stale()   ȣ Ű  ȣ Բ Ȯ
+//    ٲų,  Ű intern /  arena Ű true
+//   arena Ű ڿ operator[]  ̸ ֹǷ  ּҸ  
+// ̸  stale() false ȸ ȿϹǷ  Ϸ 
+// ϰ arena   Ƿ Ű  忡 , ٸ 忡 rankSnapshot 
+class RankView {
+public:
+	RankView() = default;
+	RankView(int list_id, size_t k, uint64_t version)
+		: list_(&rankList(list_id)), list_id_(list_id), version_(version),
+		storage_(g_keywords.storageVersion()), size_(std::min(k, rankList(list_id).size())) {}
+
+	size_t size() const { return size_; }
+	bool empty() const { return size_ == 0; }
+	uint64_t version() const { return version_; }
+	bool stale() const {
+		return list_id_ < 0 || (version_ & 1) != 0
+			|| g_rankVersion[list_id_].load(std::memory_order_acquire) != version_
+			|| g_keywords.storageVersion() != storage_;
+	}
+
+	RankEntry operator[](size_t rank) const {
+		//  پ  о    ( stale() Ȯ)
+		if (rank >= list_->size() || g_keywords.storageVersion() != storage_)
+			return { { nullptr, nullptr }, 0 };
+		const Node2& node = (*list_)[list_->size() - 1 - rank];
+		return { node.name.text(), node.point };
+	}
+
+private:
+	const std::vector<Node2>* list_ = nullptr;
+	int list_id_ = -1;
+	uint64_t version_ = 0;
+	uint64_t storage_ = 0;
+	size_t size_ = 0;
+};
+
+// "monday" ~ "sunday" -> 0..6, "weekday" / "weekend" -> 7 / 8,   -1
+int rankListIdFor(const std::string& which) {
+	if (which == "weekday")
+		return 7;
+	if (which == "weekend")
+		return 8;
+	auto it = dayToIndex.find(which);
+	return (it == dayToIndex.end()) ? -1 : it->second;
+}
+
+//  Ǵ /ָ   k view
+// б⸸ ϹǷ resetScore()        point  ( )
+RankView topK(const std::string& which, size_t k = std::numeric_limits<size_t>::max()) {
+	const int list_id = rankListIdFor(which);
+	if (list_id < 0)
+		return RankView();
+	return RankView(list_id, k, g_rankVersion[list_id].load(std::memory_order_acquire));
+}
+
+//   ȣ,     ٽ  ʿ  (Ȧ  )
+uint64_t rankVersion(const std::string& which) {
+	const int list_id = rankListIdFor(which);
+	if (list_id < 0)
+		return 0;
+	return g_rankVersion[list_id].load(std::memory_order_acquire);
+}
+
+// ٸ 忡 д  纻 (rank 0 1), Խ ڷδ ٲ 
+// ̸ 纻  ۸ ŰǷ 纻  ִ   /   а,
+//  / intern Ҹ  Ƿ arena ̵̳ Ű  
+class RankSnapshot {
+public:
+	size_t size() const { return entries_.size(); }
+	bool empty() const { return entries_.empty(); }
+	// Խ    ȣ (rankVersion() ٸ  ڷ  ٲ)
+	uint64_t version() const { return version_; }
+
+	RankEntry operator[](size_t rank) const {
+		const Entry& entry = entries_[rank];
+		const char* first = text_.data() + entry.offset;
+		return { { first, first + entry.length }, entry.point };
+	}
+
+private:
+	friend class RankPublisher;
+
+	struct Entry {
+		uint32_t offset;
+		uint32_t length;
+		int point;
+	};
+
+	std::vector<char> text_;    // ̸ KeywordTableó  ۿ ̾ 
+	std::vector<Entry> entries_;
+	uint64_t version_ = 0;
+};
+
+using RankSnapshotPtr = std::shared_ptr<const RankSnapshot>;
+
+// Ϻ 纻 Խ
+// д (rankSnapshot)  纻 shared_ptr  (  ,  /  ),
+//    Խ  д   ̶  ϸ  纻 ٲ
+//   д   Խ  ,   Ƚ ϰ   ϸ ִ  
+//   ( 纻 ϳ Ҵϰ,  纻   ִ    )
+//  depth  (⺻  ũ⿡  д    ûϸ  Խú þ)
+class RankPublisher {
+public:
+	RankPublisher() : current_(std::make_shared<const RankSnapshot>()) {}
+
+	// д : о ˸  纻 
+	RankSnapshotPtr poll(size_t k) {
+		// Խ  k ø (ٸ д   ÷ ״)
+		size_t depth = depth_.load(std::memory_order_relaxed);
+		while (depth < k && !depth_.compare_exchange_weak(depth, k, std::memory_order_relaxed))
+			;
+		polled_.store(true, std::memory_order_relaxed);
+		return std::atomic_load_explicit(&current_, std::memory_order_acquire);
+	}
+
+	//  :  Խ     list Խϰ true,  Խ ʰ false
+	bool publish(const std::vector<Node2>& list, uint64_t version) {
+		if (!polled_.exchange(false, std::memory_order_relaxed))
+			return false;
+		const size_t wanted = depth_.load(std::memory_order_relaxed);
+		const size_t size = std::min(list.size(), wanted);
+		auto next = std::make_shared<RankSnapshot>();
+		next->entries_.reserve(size);
+		for (size_t rank = 0; rank < size; rank++) {
+			const Node2& node = list[list.size() - 1 - rank];
+			const CharRange name = node.name.text();
+			next->entries_.push_back({ static_cast<uint32_t>(next->text_.size()), static_cast<uint32_t>(name.size()), node.point });
+			next->text_.insert(next->text_.end(), name.begin(), name.end());
+		}
+		next->version_ = version;
+		publishedDepth_ = wanted;
+		std::atomic_store_explicit(&current_, RankSnapshotPtr(std::move(next)), std::memory_order_release);
+		return true;
+	}
+
+	//  Խ  д    ׸ û true ( )
+	bool wantsDeeper() const { return depth_.load(std::memory_order_relaxed) > publishedDepth_; }
+
+private:
+	RankSnapshotPtr current_;     // std::atomic_load / atomic_storeθ 
+	std::atomic<bool> polled_{ false };
+	std::atomic<size_t> depth_{ kDefaultRankCapacity };
+	size_t publishedDepth_ = 0;   //  常 
+};
+
+RankPublisher g_rankPublishers[kRankListCount];
+
+// ٲ ϰ д    û    Խ    ִ ͸ Խ
+// Խ   ǥø  ξٰ д    Խÿ ó
+void publishRankSnapshots() {
+	for (int list_id = 0; list_id < kRankListCount; ++list_id) {
+		const unsigned bit = 1u << list_id;
+		if (!(g_rankDirty & bit) && !g_rankPublishers[list_id].wantsDeeper())
+			continue;
+		const uint64_t version = g_rankVersion[list_id].load(std::memory_order_relaxed);
+		if (g_rankPublishers[list_id].publish(rankList(list_id), version))
+			g_rankDirty &= ~bit;
+	}
+}
+
+//  Ǵ /ָ   Խõ 纻, Ű ٸ 忡 ȣ  ( / õ /  )
+// ϴ :
+//   - 纻 shared_ptr  ִ  ٲ ʰ ȿ,  (   ) ϰ 
+//   -  ȣ   尡 ó   (updateKeywordBy   ) ׶  Խõ
+//  ʴ :
+//   -  纻 ̶ֽ :  ȣ  ù    ̹Ƿ      
+//     (version() rankVersion()  ֽ),     ű  纻 
+//   - ó б   纻
+//  k    Խú (  纻 ⺻  ũ)
+//  Լ(updateKeywordBy, addKeyword, setRankCapacity )  忡 ȣ
+RankSnapshotPtr rankSnapshot(const std::string& which, size_t k = kDefaultRankCapacity) {
+	static const RankSnapshotPtr kEmpty = std::make_shared<const RankSnapshot>();
+	const int list_id = rankListIdFor(which);
+	if (list_id < 0)
+		return kEmpty;
+	return g_rankPublishers[list_id].poll(k);
+}
+
+void addKeyword(std::vector<Node2>& node, const std::string& keyword, int point);
+
+string updateKeywordBy(const string& keyword, const string& day) {
+	RankWriteBatch batch;
+
+	// Decay  UZ  64Ʈ ð踦 ϰ resetScore() ʿ 
+	const bool decay = (g_scoreMode == ScoreMode::Decay);
+	if (decay)
+		g_scoreClock++;
+	else
+		UZ++;
+
+	int day_index = dayToIndex[day];
+	int weekend_index = (day_index >= dayToIndex["monday"] && day_index <= dayToIndex["friday"]) ? 0 : 1;
+	syncScoreGeneration(day_index);
+	syncScoreGeneration(7 + weekend_index);
+
+	// ϸ  ٸ  Ƿ (Decay ) Ϻ 
+	const int day_point = currentPoint(day_index);
+	const int two_point = currentPoint(7 + weekend_index);
+
+	// Ͽ ϴ Ȯ
+	//Ǵ Ű̸  
+
+	long long int maxPoint_day = 0;
+	long long int maxPoint_weekdayOrWeekend = 0;
+
+	// Ͽ intern Ű常 Ƿ id  Ϻ HIT 
+	const uint32_t keyword_id = g_keywords.find(keyword);
+
+	// ̹ ȣ HIT  / ϡָ ࿡    (two_counted: ϡָ ࿡ ̹ )
+	bool isPerfectHit = false;
+	bool two_counted = false;
+	int slot = findRankSlot(DayBest[day_index], keyword_id);
+	if (slot >= 0) {
+		Node2& node = DayBest[day_index][slot];
+		beginRankWrite(day_index);
+		maxPoint_day = node.point = bumpPoint(node.point, day_point);
+		g_heavyHitters[day_index].add(node.name.hash());
+		raiseRanked(DayBest[day_index], slot, &g_rankIndex[day_index], &g_rankColumns[day_index]);
+		endRankWrite(day_index);
+		isPerfectHit = true;
+	}
+
+	slot = findRankSlot(twoBest[weekend_index], keyword_id);
+	if (slot >= 0) {
+		Node2& node = twoBest[weekend_index][slot];
+		beginRankWrite(7 + weekend_index);
+		maxPoint_weekdayOrWeekend = node.point = bumpPoint(node.point, two_point);
+		g_heavyHitters[7 + weekend_index].add(node.name.hash());
+		raiseRanked(twoBest[weekend_index], slot, &g_rankIndex[7 + weekend_index], &g_rankColumns[7 + weekend_index]);
+		endRankWrite(7 + weekend_index);
+		two_counted = true;
+	}
+
+	// ۾
+	if (!decay && (UZ >= 2100000000 || maxPoint_day >= 2100000000 || maxPoint_weekdayOrWeekend >= 2100000000)) {
+		resetScore();
+		// ̹ ȣ   ϸ ٷ ,    
+		syncScoreGeneration(day_index);
+		syncScoreGeneration(7 + weekend_index);
+	}
+
+	//Ϻ HIT
+	if (isPerfectHit) {
+		// ϡָ Ͽ  Ű嵵  ࿡ HIT  (ڰ Ǹ )
+		if (!two_counted)
+			recordRankHit(7 + weekend_index, keyword, two_point);
+		return keyword;
+	}
+
+	// HIT (ã Ű HIT , point ״)
+	int similar_index = findSimilarIndex(keyword, DayBest[day_index]);
+	if (similar_index >= 0) {
+		string similar = DayBest[day_index][similar_index].name.str();
+		recordRankHit(day_index, similar, day_point);
+		if (!two_counted)
+			recordRankHit(7 + weekend_index, similar, two_point);
+		return similar;
+	}
+
+	similar_index = findSimilarIndex(keyword, twoBest[weekend_index]);
+	if (similar_index >= 0) {
+		string similar = twoBest[weekend_index][similar_index].name.str();
+		if (!two_counted)
+			recordRankHit(7 + weekend_index, similar, two_point);
+		recordRankHit(day_index, similar, day_point);
+		return similar;
+	}
+
+	//Ϻ HIT /  HIT Ѵ ƴѰ
+	auto& dayNode = DayBest[day_index];
+	addKeyword(dayNode, keyword, day_point);
+
+	if (!two_counted) {
+		auto& twoNode = twoBest[weekend_index];
+		addKeyword(twoNode, keyword, two_point);
+	}
+
+	return keyword;
+}
+
+void addKeyword(std::vector<Node2>& node, const std::string& keyword, int point)
+{
+	const int list_id = rankListId(node);
+	if (list_id < 0) {
+		insertRanked(node, g_rankCapacity, keyword, point, nullptr);
+		return;
+	}
+	// resetScore()  ó ̸ ĵ point ؾ  ( ȣ⵵ )
+	syncScoreGeneration(list_id);
+	recordRankHit(list_id, keyword, point);
+}
+
+
+void findBetterKeywords() {
+	ifstream fin{ "keyword_weekday_500.txt" }; //500  Է
+	for (int i = 0; i < 500; i++) {
+		string keyword, day;
+		fin >> keyword >> day;
+		string ret = updateKeywordBy(keyword, day);
+		std::cout << ret << "\n";
+	}
+}
+
+
+// test ///////////////
+
+//  Ҵ Ƚ   operator new / delete ü (, 迭, sized, nothrow   malloc / free ,   ´  )
+// α׷ ü Ҵ ⸦ Ƿ ׽Ʈ 忡  (FIX_KEYWORD_COUNT_ALLOCATIONS, Debug )
+// ٸ 忡 ҴϹǷ counter atomic
+// Ҵ /  ȣ ġ ζϸ GCC new  free Ѵٰ  ϹǷ ζ 
+#ifdef FIX_KEYWORD_COUNT_ALLOCATIONS
+constexpr bool kCountAllocations = true;
+std::atomic<size_t> g_allocCount{ 0 };
+
+NO_INLINE void* countedAlloc(size_t size) {
+	g_allocCount.fetch_add(1, std::memory_order_relaxed);
+	void* p = std::malloc(size ? size : 1);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+NO_INLINE void countedFree(void* p) noexcept {
+	std::free(p);
+}
+
+void* operator new(size_t size) {
+	return countedAlloc(size);
+}
+
+void* operator new[](size_t size) {
+	return countedAlloc(size);
+}
+
+void operator delete(void* p) noexcept {
+	countedFree(p);
+}
+
+void operator delete[](void* p) noexcept {
+	countedFree(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+	countedFree(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+	countedFree(p);
+}
+
+// nothrow  (std::stable_sort ӽ  ),  delete ǹǷ  malloc Ҵ
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+	g_allocCount.fetch_add(1, std::memory_order_relaxed);
+	return std::malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+	g_allocCount.fetch_add(1, std::memory_order_relaxed);
+	return std::malloc(size ? size : 1);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+	countedFree(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+	countedFree(p);
+}
+
+//  (align_val_t) , MSVC _aligned_malloc   _aligned_freeθ   
+NO_INLINE void* countedAlignedAlloc(size_t size, std::align_val_t align) noexcept {
+	g_allocCount.fetch_add(1, std::memory_order_relaxed);
+	const size_t alignment = static_cast<size_t>(align);
+#ifdef _MSC_VER
+	return _aligned_malloc(size ? size : 1, alignment);
+#else
+	// aligned_alloc ũⰡ alignment  
+	return std::aligned_alloc(alignment, ((size ? size : 1) + alignment - 1) / alignment * alignment);
+#endif
+}
+
+NO_INLINE void countedAlignedFree(void* p) noexcept {
+#ifdef _MSC_VER
+	_aligned_free(p);
+#else
+	std::free(p);
+#endif
+}
+
+void* operator new(size_t size, std::align_val_t align) {
+	void* p = countedAlignedAlloc(size, align);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t size, std::align_val_t align) {
+	void* p = countedAlignedAlloc(size, align);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+	return countedAlignedAlloc(size, align);
+}
+
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+	return countedAlignedAlloc(size, align);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+	countedAlignedFree(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+	countedAlignedFree(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+	countedAlignedFree(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept {
+	countedAlignedFree(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+	countedAlignedFree(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+	countedAlignedFree(p);
+}
+
+long long allocationCount() {
+	return static_cast<long long>(g_allocCount.load(std::memory_order_relaxed));
+}
+#else
+constexpr bool kCountAllocations = false;
+
+long long allocationCount() {
+	return 0;
+}
+#endif
+
+// ׽Ʈ:   ° ٲ   / ޸ /  / heavy hitter   Ͽ 
+void rankListReplaced(int list_id) {
+	rankListChanged(list_id, rankList(list_id));
+	g_listScoreGeneration[list_id] = g_scoreGeneration;
+	g_heavyHitters[list_id].clear();
+}
+
+// ׽Ʈ   
+//    ϰ UZ / ð /  ũ⸦ ϰ, Ҹ  Legacy    ǵ
+// (ASSERT  ǹǷ  ׽Ʈ °  )
+class RankStateGuard {
+public:
+	RankStateGuard() : uz_(UZ), clock_(g_scoreClock), capacity_(g_rankCapacity) {
+		for (int list_id = 0; list_id < kRankListCount; ++list_id)
+			saved_[list_id] = rankList(list_id);
+	}
+
+	~RankStateGuard() {
+		if (g_scoreMode != ScoreMode::Legacy)
+			setScoreMode(ScoreMode::Legacy);
+		if (g_rankCapacity != capacity_)
+			setRankCapacity(capacity_);
+		UZ = uz_;
+		g_scoreClock = clock_;
+		for (int list_id = 0; list_id < kRankListCount; ++list_id) {
+			rankList(list_id) = saved_[list_id];
+			rankListReplaced(list_id);
+		}
+	}
+
+	//  ϳ  (list_id < 0̸ ü)
+	void clear(int list_id = -1) {
+		for (int id = 0; id < kRankListCount; ++id) {
+			if (list_id >= 0 && id != list_id)
+				continue;
+			rankList(id).clear();
+			rankListReplaced(id);
+		}
+	}
+
+private:
+	std::vector<Node2> saved_[kRankListCount];
+	int uz_;
+	long long clock_;
+	size_t capacity_;
+};
+
+TEST(KeywordTest, PerfectHit) {
+	string keyword = "banana";
+	string day = "tuesday";
+	updateKeywordBy(keyword, day); //  ߰
+	int prevPoint = DayBest[1][0].point;
+	string result = updateKeywordBy(keyword, day); // Ϻ HIT
+	EXPECT_EQ(result, keyword);
+}
+
+TEST(KeywordTest, BasicAssertions) {
+	string keyword = "test_keyword";
+	string day = "monday";
+	string result = updateKeywordBy(keyword, day);
+	EXPECT_EQ(result, keyword); 
+}
+
+TEST(KeywordTest, UZ_weekday) {
+	UZ = 2100000000;
+	updateKeywordBy("assd", "monday");
+	EXPECT_EQ(UZ, 9);
+}
+
+TEST(KeywordTest, UZ_weekend) {
+	UZ = 2100000000;
+	updateKeywordBy("assd", "sunday");
+	EXPECT_EQ(UZ, 9);
 }
 
 TEST(KeywordTest, EmptyKeyword) {
 	string keyword = "";
-	string day = "sunday";
+	string day = "sunday";
+	string result = updateKeywordBy(keyword, day);
+	EXPECT_EQ(result, keyword);
+	EXPECT_EQ(DayBest[6][0].name, keyword);
+}
+
+TEST(KeywordTest, EmptyKeyword2) {
+	string keyword = "";
+	string day = "tuesday";
+	string result = updateKeywordBy(keyword, day);
+	EXPECT_EQ(result, keyword);
+}
+
+TEST(KeywordTest, 2weeksInput) {
+	string keyword = "a";
+	string day = "monday";
+	updateKeywordBy(keyword, day);
+	string result = updateKeywordBy(keyword, day); 
+	EXPECT_EQ(result, keyword);
+
+	keyword = "b";
+	day = "tuesday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day); 
+	EXPECT_EQ(result, keyword);
+
+	keyword = "c";
+	day = "wednesday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day); 
+	EXPECT_EQ(result, keyword);
+
+	keyword = "d";
+	day = "thursday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day); 
+	EXPECT_EQ(result, keyword);
+
+	keyword = "e";
+	day = "friday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day); 
+	EXPECT_EQ(result, keyword);
+
+	keyword = "f";
+	day = "saturday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day); 
+	EXPECT_EQ(result, keyword);
+
+	keyword = "g";
+	day = "sunday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day); 
+	EXPECT_EQ(result, keyword);
+
+
+
+
+	keyword = "a";
+	day = "monday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day); 
+	EXPECT_EQ(result, keyword);
+
+	keyword = "b";
+	day = "tuesday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day); 
+	EXPECT_EQ(result, keyword);
+
+	keyword = "c";
+	day = "wednesday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day); 
+	EXPECT_EQ(result, keyword);
+
+	keyword = "d";
+	day = "thursday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day); 
+	EXPECT_EQ(result, keyword);
+
+	keyword = "e";
+	day = "friday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day); 
+	EXPECT_EQ(result, keyword);
+
+	keyword = "f";
+	day = "saturday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day); 
+	EXPECT_EQ(result, keyword);
+
+	keyword = "g";
+	day = "sunday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day); 
+	EXPECT_EQ(result, keyword);
+
+
+}
+
+TEST(KeywordTest, monday14) {
+	string keyword = "a";
+	string day = "monday";
+	updateKeywordBy(keyword, day);
+	string result = updateKeywordBy(keyword, day);
+	EXPECT_EQ(result, keyword);
+
+	keyword = "b";
+	day = "monday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day);
+	EXPECT_EQ(result, keyword);
+
+	keyword = "c";
+	day = "monday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day);
+	EXPECT_EQ(result, keyword);
+
+	keyword = "d";
+	day = "monday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day);
+	EXPECT_EQ(result, keyword);
+
+	keyword = "e";
+	day = "monday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day);
+	EXPECT_EQ(result, keyword);
+
+	keyword = "f";
+	day = "monday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day);
+	EXPECT_EQ(result, keyword);
+
+	keyword = "g";
+	day = "monday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day);
+	EXPECT_EQ(result, keyword);
+
+
+
+
+	keyword = "a";
+	day = "monday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day);
+	EXPECT_EQ(result, keyword);
+
+	keyword = "b";
+	day = "monday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day);
+	EXPECT_EQ(result, keyword);
+
+	keyword = "c";
+	day = "monday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day);
+	EXPECT_EQ(result, keyword);
+
+	keyword = "d";
+	day = "monday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day);
+	EXPECT_EQ(result, keyword);
+
+	keyword = "e";
+	day = "monday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day);
+	EXPECT_EQ(result, keyword);
+
+	keyword = "f";
+	day = "monday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day);
+	EXPECT_EQ(result, keyword);
+
+	keyword = "g";
+	day = "monday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day);
+	EXPECT_EQ(result, keyword);
+
+
+}
+
+TEST(KeywordTest, sameName) {
+	string keyword = "aaaaaab";
+	string day = "monday";
+	updateKeywordBy(keyword, day);
+	string result = updateKeywordBy(keyword, day);
+	EXPECT_EQ(result, keyword);
+
+	keyword = "aaaaaaa";
+	day = "monday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day);
+	EXPECT_EQ(result, result);
+}
+
+TEST(KeywordTest, mainFunction) {
+	findBetterKeywords();
+}
+
+
+TEST(KeywordTest, EmptyDouble) {
+	string keyword = "";
+	string day = "monday";
+	updateKeywordBy(keyword, day);
 	string result = updateKeywordBy(keyword, day);
 	EXPECT_EQ(result, keyword);
-	EXPECT_EQ(DayBest[6][0].name, keyword);
+
+	keyword = "";
+	day = "monday";
+	updateKeywordBy(keyword, day);
+	result = updateKeywordBy(keyword, day);
+	EXPECT_EQ(result, result);
+}
+
+// ׽Ʈ  Ű  ( ĺ  ڿ  )
+string makeRandomKeyword(std::mt19937& rng, size_t len, int alphabet) {
+	string s(len, 'a');
+	for (char& c : s)
+		c = static_cast<char>('a' + rng() % alphabet);
+	return s;
+}
+
+//  ڿ   
+string mutateKeyword(std::mt19937& rng, string s, int edits, int alphabet) {
+	for (int e = 0; e < edits; e++) {
+		size_t pos = s.empty() ? 0 : rng() % (s.size() + 1);
+		switch (rng() % 3) {
+		case 0: s.insert(s.begin() + pos, static_cast<char>('a' + rng() % alphabet)); break;
+		case 1: if (pos < s.size()) s.erase(s.begin() + pos); break;
+		default: if (pos < s.size()) s[pos] = static_cast<char>('a' + rng() % alphabet); break;
+		}
+	}
+	return s;
+}
+
+TEST(ScorerTest, BitParallelMatchesLevenshtein) {
+	std::mt19937 rng(2025);
+	for (int iter = 0; iter < 3000; iter++) {
+		size_t len = rng() % 200;
+		int alphabet = 2 + rng() % 10;
+		string a = makeRandomKeyword(rng, len, alphabet);
+		string b = (iter % 2) ? mutateKeyword(rng, a, rng() % 8, alphabet)
+			: makeRandomKeyword(rng, rng() % 200, alphabet);
+		EXPECT_EQ(levenshteinBitParallel(a, b), levenshtein(a, b)) << a << " / " << b;
+		EXPECT_EQ(g_bitParallelScorer.score(a, b), g_levenshteinScorer.score(a, b));
+	}
+}
+
+TEST(ScorerTest, BitParallelWordBoundary) {
+	string a(64, 'x');
+	string b(65, 'x');
+	EXPECT_EQ(levenshteinBitParallel(a, b), 1);
+	EXPECT_EQ(levenshteinBitParallel(b + "yy", a), 3);
+	EXPECT_EQ(levenshteinBitParallel(string(128, 'a'), string(128, 'b')), 128);
+	EXPECT_EQ(levenshteinBitParallel("", "abc"), 3);
+}
+
+TEST(ScorerTest, BoundedMatchesFullDistance) {
+	std::mt19937 rng(80);
+	for (int iter = 0; iter < 3000; iter++) {
+		int alphabet = 2 + rng() % 6;
+		string a = makeRandomKeyword(rng, rng() % 40, alphabet);
+		string b = mutateKeyword(rng, a, rng() % 10, alphabet);
+		int full = levenshtein(a, b);
+		int max_dist = rng() % 12;
+		EXPECT_EQ(levenshteinBounded(a, b, max_dist), std::min(full, max_dist + 1)) << a << " / " << b;
+	}
+}
+
+TEST(ScorerTest, BoundedSimilarMatchesScore) {
+	std::mt19937 rng(99);
+	for (int iter = 0; iter < 3000; iter++) {
+		int alphabet = 2 + rng() % 6;
+		string a = makeRandomKeyword(rng, rng() % 30, alphabet);
+		string b = mutateKeyword(rng, a, rng() % 6, alphabet);
+		int threshold = (iter % 3 == 0) ? 80 : 1 + rng() % 100;
+		EXPECT_EQ(g_levenshteinScorer.isSimilar(a, b, threshold),
+			g_levenshteinScorer.score(a, b) >= threshold) << a << " / " << b << " / " << threshold;
+	}
+}
+
+TEST(ScorerTest, IntegerScoreMatchesLegacyExhaustive) {
+	for (int len = 1; len <= 1024; len++) {
+		int expected_bound = -1;
+		for (int d = 0; d <= len; d++) {
+			const int legacy = legacyScoreFromDistance(d, len);
+			ASSERT_EQ(scoreFromDistance(d, len), legacy) << len << " / " << d;
+			if (legacy >= SIMILAR_THRESHOLD)
+				expected_bound = d;
+		}
+		ASSERT_EQ(kSimilarDistanceBound.maxDist[len], expected_bound) << len;
+		ASSERT_EQ(maxDistanceFor(len, SIMILAR_THRESHOLD), expected_bound) << len;
+	}
+}
+
+TEST(ScorerTest, MaxDistanceForAnyThreshold) {
+	for (int threshold = 0; threshold <= 101; threshold++) {
+		for (int len = 1; len <= 400; len++) {
+			int expected = -1;
+			for (int d = 0; d <= len; d++) {
+				if (legacyScoreFromDistance(d, len) >= threshold)
+					expected = d;
+			}
+			ASSERT_EQ(maxDistanceFor(len, threshold), expected) << len << " / " << threshold;
+		}
+	}
+}
+
+TEST(ScorerTest, MaxDistanceForThreshold) {
+	for (int len = 1; len <= 300; len++) {
+		int d = maxDistanceFor(len, 80);
+		EXPECT_GE(scoreFromDistance(d, len), 80);
+		if (d < len) {
+			EXPECT_LT(scoreFromDistance(d + 1, len), 80);
+		}
+	}
+}
+
+TEST(ScorerTest, LongInputUsesScratchRows) {
+	string a(300, 'a');
+	string b = a;
+	b[150] = 'b';
+	b += "cc";
+	EXPECT_EQ(levenshtein(a, b), 3);
+	EXPECT_EQ(levenshteinBounded(a, b, 5), 3);
+	EXPECT_EQ(levenshteinBounded(a, b, 2), 3);
+}
+
+// ޸ /  ĳÿ ɸ Ÿ  ǳʶٹǷ   Ź ȿȭؼ scorer DP / Ʈ  θ  ¿
+void forgetSimilarityVerdicts(const string& day) {
+	const int day_index = dayToIndex[day];
+	invalidateSimilarityMemo(day_index);
+	invalidateSimilarityMemo(7 + ((day_index <= 4) ? 0 : 1));
+}
+
+// ȯ string̹Ƿ SSO(15Ʈ)  Ű常 Ҵ 0ȸ,
+//  Ű ȯ ڿ 1ȸ ܿ Ҵ 
+// ⺻ scorer(Ʈ ) Ÿ scorer(DP  )  
+TEST(KeywordTest, SteadyStateNoHeapAllocation) {
+	if (!kCountAllocations)
+		GTEST_SKIP() << "FIX_KEYWORD_COUNT_ALLOCATIONS 忡 ";
+	const string day = "friday";
+	const string exact = "zucchini";
+	const string typo = "zucchinis";
+	const ISimilarityScorer* scorers[] = { &g_bitParallelScorer, &g_levenshteinScorer };
+	for (const ISimilarityScorer* scorer : scorers) {
+		setSimilarityScorer(scorer);
+		updateKeywordBy(exact, day);
+		updateKeywordBy(exact, day);
+		updateKeywordBy(typo, day);
+
+		long long before = allocationCount();
+		for (int i = 0; i < 100; i++) {
+			updateKeywordBy(exact, day); // Ϻ HIT
+			forgetSimilarityVerdicts(day);
+			updateKeywordBy(typo, day);  //  HIT (޸  Ÿ )
+		}
+		long long allocs = allocationCount() - before;
+
+		EXPECT_EQ(allocs, 0);
+		EXPECT_EQ(updateKeywordBy(typo, day), exact);
+	}
+	setSimilarityScorer(&g_bitParallelScorer);
+}
+
+TEST(KeywordTest, SteadyStateLongKeywordAllocatesOnlyResult) {
+	if (!kCountAllocations)
+		GTEST_SKIP() << "FIX_KEYWORD_COUNT_ALLOCATIONS 忡 ";
+	const string day = "thursday";
+	const string exact = "extraordinarily-long-courgette-recipe";
+	const string typo = "extraordinarily-long-courgette-recipes";
+	ASSERT_GT(exact.size(), 15u);
+	updateKeywordBy(exact, day);
+	updateKeywordBy(exact, day);
+	updateKeywordBy(typo, day);
+
+	long long before = allocationCount();
+	for (int i = 0; i < 100; i++) {
+		updateKeywordBy(exact, day); // Ϻ HIT
+		forgetSimilarityVerdicts(day);
+		updateKeywordBy(typo, day);  //  HIT (޸  Ÿ )
+	}
+	long long allocs = allocationCount() - before;
+
+	EXPECT_EQ(allocs, 200);
+	EXPECT_EQ(updateKeywordBy(typo, day), exact);
+}
+
+TEST(ScorerTest, AntiDiagonalKernelsMatchLevenshtein) {
+	std::vector<SimdLevel> levels = { SimdLevel::Scalar };
+	if (g_simdLevel >= SimdLevel::Sse41) levels.push_back(SimdLevel::Sse41);
+	if (g_simdLevel >= SimdLevel::Avx2) levels.push_back(SimdLevel::Avx2);
+	if (g_simdLevel >= SimdLevel::Avx512) levels.push_back(SimdLevel::Avx512);
+
+	std::mt19937 rng(4);
+	for (int iter = 0; iter < 500; iter++) {
+		int alphabet = 2 + rng() % 20;
+		string a = makeRandomKeyword(rng, rng() % 300, alphabet);
+		string b = (iter % 2) ? mutateKeyword(rng, a, rng() % 30, alphabet)
+			: makeRandomKeyword(rng, rng() % 300, alphabet);
+		int expected = levenshtein(a, b);
+		for (SimdLevel level : levels)
+			EXPECT_EQ(levenshteinAntiDiagonal(a, b, diagonalKernelFor(level)), expected)
+				<< "level " << static_cast<int>(level);
+	}
+}
+
+TEST(ScorerTest, SimdScorerMatchesLevenshtein) {
+	std::mt19937 rng(44);
+	for (int iter = 0; iter < 500; iter++) {
+		string a = makeRandomKeyword(rng, 50 + rng() % 200, 4);
+		string b = mutateKeyword(rng, a, rng() % 40, 4);
+		EXPECT_EQ(g_simdScorer.score(a, b), g_levenshteinScorer.score(a, b));
+	}
+	const ISimilarityScorer* saved = g_scorer;
+	setSimilarityScorer(&g_simdScorer);
+	EXPECT_TRUE(similer("banana", "bananas"));
+	setSimilarityScorer(saved);
+}
+
+TEST(ScorerTest, BatchedFindFirstSimilar) {
+	std::mt19937 rng(5);
+	for (int iter = 0; iter < 1000; iter++) {
+		string query = makeRandomKeyword(rng, rng() % 20, 4);
+		std::vector<Node2> candidates;
+		for (int c = 0; c < 10; c++)
+			candidates.push_back({ mutateKeyword(rng, query, rng() % 5, 4), c });
+		if (iter % 10 == 0)
+			candidates.push_back({ "", 0 });
+
+		int expected = -1;
+		for (size_t i = 0; i < candidates.size(); i++) {
+			if (g_levenshteinScorer.score(candidates[i].name.str(), query) >= SIMILAR_THRESHOLD) {
+				expected = static_cast<int>(i);
+				break;
+			}
+		}
+		EXPECT_EQ(g_levenshteinScorer.findFirstSimilar(query, candidates, SIMILAR_THRESHOLD), expected);
+		EXPECT_EQ(g_bitParallelScorer.findFirstSimilar(query, candidates, SIMILAR_THRESHOLD), expected);
+	}
+}
+
+TEST(ScorerTest, MatchProfileDistance) {
+	std::mt19937 rng(6);
+	for (int iter = 0; iter < 2000; iter++) {
+		int alphabet = 2 + rng() % 30;
+		string name = makeRandomKeyword(rng, 1 + rng() % 64, alphabet);
+		string query = mutateKeyword(rng, name, rng() % 10, alphabet);
+		MatchProfile profile = buildMatchProfile(name);
+		int full = levenshtein(name, query);
+		EXPECT_EQ(myersDistanceProfile(profile, query, 1000), full);
+		EXPECT_EQ(myersDistanceProfile(profile, query, 3), std::min(full, 4));
+
+		KeywordSketch query_sketch;
+		buildSketch(query, query_sketch);
+		EXPECT_LE(histogramDistanceBound(profile.sketch.histogram, query_sketch.histogram), full);
+	}
+}
+
+TEST(ScorerTest, PrefiltersNeverRejectCloseStrings) {
+	std::mt19937 rng(7);
+	PrefilterStats before = g_prefilterStats;
+	for (int iter = 0; iter < 5000; iter++) {
+		int alphabet = 2 + rng() % 26;
+		string a = makeRandomKeyword(rng, rng() % 40, alphabet);
+		string b = (iter % 2) ? mutateKeyword(rng, a, rng() % 8, alphabet)
+			: makeRandomKeyword(rng, rng() % 40, alphabet);
+		KeywordSketch sa, sb;
+		buildSketch(a, sa);
+		buildSketch(b, sb);
+		int dist = levenshtein(a, b);
+		for (int max_dist = dist; max_dist < dist + 3; max_dist++)
+			EXPECT_TRUE(passesPrefilters(sa, sb, max_dist)) << a << " / " << b;
+		passesPrefilters(sa, sb, dist / 2);
+	}
+	const PrefilterStats& after = g_prefilterStats;
+	long long rejected = (after.rejectedByLength - before.rejectedByLength)
+		+ (after.rejectedByHistogram - before.rejectedByHistogram)
+		+ (after.rejectedByBigram - before.rejectedByBigram);
+	EXPECT_EQ(after.checked - before.checked, rejected + (after.passed - before.passed));
+	EXPECT_GT(after.rejectedByBigram, before.rejectedByBigram);
+}
+
+TEST(ScorerTest, DefaultSimilerUsesBoundedPath) {
+	ASSERT_EQ(g_scorer, &g_bitParallelScorer);
+	std::mt19937 rng(6);
+	for (int iter = 0; iter < 3000; iter++) {
+		int alphabet = 2 + rng() % 26;
+		string a = makeRandomKeyword(rng, rng() % 80, alphabet);
+		string b = (iter % 2) ? mutateKeyword(rng, a, rng() % 4, alphabet)
+			: makeRandomKeyword(rng, rng() % 80, alphabet);
+		EXPECT_EQ(similer(a, b), g_levenshteinScorer.score(a, b) >= SIMILAR_THRESHOLD) << a << " / " << b;
+	}
+
+	//  ˻縦 ġǷ  ̸ Ǵ  迡 
+	PrefilterStats before = g_prefilterStats;
+	EXPECT_FALSE(similer("abcdefgh", "abcdefghijklmnopqrstuvwxyz"));
+	EXPECT_EQ(g_prefilterStats.rejectedByLength, before.rejectedByLength + 1);
+	EXPECT_TRUE(similer("abcdefgh", "abcdefgx"));
+	EXPECT_EQ(g_prefilterStats.passed, before.passed + 1);
+}
+
+TEST(ScorerTest, Utf8CodePointDistance) {
+	// ҽ  ڵ(CP949) Ϸ Է ڼ¿   Ʈ ǵ UTF-8 \x 
+	// ""(EA B3 BC) ""(EA B4 B4) Ʈδ 2, ڵ Ʈδ 1 
+	string apple = "\xEC\x82\xAC\xEA\xB3\xBC";  // 
+	string typo = "\xEC\x82\xAC\xEA\xB4\xB4";  // 籫
+	EXPECT_EQ(levenshtein(apple, typo), 2);
+	EXPECT_EQ(g_utf8Scorer.score(apple, typo), scoreFromDistance(1, 2));
+	const string banana = "\xEB\xB0\x94\xEB\x82\x98\xEB\x82\x98";                      // ٳ
+	const string bananaMilk = "\xEB\xB0\x94\xEB\x82\x98\xEB\x82\x98\xEC\x9A\xB0\xEC\x9C\xA0"; // ٳ
+	const string bananaTypo = "\xEB\xB0\x94\xEB\x82\x98\xEB\x82\x98\xEC\x9C\xA0";          // ٳ
+	const string strawberry = "\xEB\x94\xB8\xEA\xB8\xB0";                                  // 
+	const string strawberryMilk = strawberry + "\xEC\x9A\xB0\xEC\x9C\xA0";                   // 
+	EXPECT_EQ(g_utf8Scorer.score(banana, banana), 100);
+	EXPECT_EQ(g_utf8Scorer.score(bananaMilk, bananaTypo), scoreFromDistance(1, 5));
+	EXPECT_TRUE(g_utf8Scorer.isSimilar(strawberryMilk + "\xEB\xA7\x9B", strawberryMilk, SIMILAR_THRESHOLD)); // 
+	EXPECT_FALSE(g_utf8Scorer.isSimilar(strawberry, banana, SIMILAR_THRESHOLD));
+
+	std::vector<uint32_t> cps;
+	decodeUtf8(string("a\xff") + "\xEA\xB0\x80", cps);  // 
+	ASSERT_EQ(cps.size(), 3u);
+	EXPECT_EQ(cps[0], 'a');
+	EXPECT_EQ(cps[1], 0xDC00u + 0xFF);
+	EXPECT_EQ(cps[2], 0xAC00u);
+}
+
+TEST(ScorerTest, Utf8MatchesCodePointReference) {
+	const char* syllables[] = { "\xEA\xB0\x80", "\xEB\x82\x98", "\xEB\x8B\xA4", "\xEB\x9D\xBC", "a", "b" };  // , , , 
+	std::mt19937 rng(9);
+	for (int iter = 0; iter < 2000; iter++) {
+		std::vector<int> x(rng() % 90), y;
+		for (int& v : x) v = rng() % 6;
+		y = x;
+		for (int e = rng() % 6; e > 0 && !y.empty(); e--)
+			y[rng() % y.size()] = rng() % 6;
+		if (iter % 3 == 0) y.push_back(rng() % 6);
+
+		string a, b;
+		std::vector<uint32_t> ca, cb;
+		for (int v : x) a += syllables[v];
+		for (int v : y) b += syllables[v];
+		decodeUtf8(a, ca);
+		decodeUtf8(b, cb);
+		const int max_len = static_cast<int>(std::max(ca.size(), cb.size()));
+		if (max_len == 0)
+			continue;
+		int expected = levenshteinBounded(ca, cb, max_len);
+		EXPECT_EQ(g_utf8Scorer.score(a, b), scoreFromDistance(expected, max_len));
+		EXPECT_EQ(g_utf8Scorer.isSimilar(a, b, SIMILAR_THRESHOLD),
+			scoreFromDistance(expected, max_len) >= SIMILAR_THRESHOLD);
+	}
+}
+
+TEST(ScorerTest, Utf8AsciiFastPath) {
+	EXPECT_TRUE(isAscii("banana_banana_banana"));
+	EXPECT_FALSE(isAscii(string("banana_banana_banana") + "\xEB\x82\x98"));  // 
+	std::mt19937 rng(90);
+	for (int iter = 0; iter < 1000; iter++) {
+		string a = makeRandomKeyword(rng, rng() % 40, 5);
+		string b = mutateKeyword(rng, a, rng() % 6, 5);
+		EXPECT_EQ(g_utf8Scorer.score(a, b), g_levenshteinScorer.score(a, b));
+	}
+}
+
+TEST(ScorerTest, PolicyEngineMatchesVirtual) {
+	std::mt19937 rng(10);
+	for (int iter = 0; iter < 1000; iter++) {
+		string query = makeRandomKeyword(rng, rng() % 80, 4);
+		std::vector<Node2> candidates;
+		for (int c = 0; c < 10; c++) {
+			candidates.push_back({ mutateKeyword(rng, query, rng() % 6, 4), c });
+		}
+		int expected = g_levenshteinScorer.ISimilarityScorer::findFirstSimilar(query, candidates, SIMILAR_THRESHOLD);
+		EXPECT_EQ(SimilarityEngine<LevenshteinPolicy>::findFirstSimilar(query, candidates, SIMILAR_THRESHOLD), expected);
+		EXPECT_EQ(SimilarityEngine<BitParallelPolicy>::findFirstSimilar(query, candidates, SIMILAR_THRESHOLD), expected);
+	}
+}
+
+TEST(ScorerTest, AffixTrimming) {
+	string a = "banana_smoothie_recipe";
+	string b = "banana_smothie_recipe";
+	AffixTrim trim = trimCommonAffixes(a.data(), a.size(), b.data(), b.size());
+	EXPECT_EQ(trim.prefix, 10u);
+	EXPECT_EQ(trim.suffix, 11u);
+	EXPECT_EQ(levenshteinBounded(a, b, 3), 1);
+
+	string same = "strawberry";
+	trim = trimCommonAffixes(same.data(), same.size(), same.data(), same.size());
+	EXPECT_EQ(trim.prefix + trim.suffix, same.size());
+
+	// λ ̻簡 ġ  ("aaa" / "aaaa")
+	trim = trimCommonAffixes("aaa", 3, "aaaa", 4);
+	EXPECT_EQ(trim.prefix + trim.suffix, 3u);
+}
+
+TEST(ScorerTest, TrimmedKernelsMatchFullDistance) {
+	std::mt19937 rng(11);
+	for (int iter = 0; iter < 3000; iter++) {
+		string stem = makeRandomKeyword(rng, rng() % 30, 26);
+		string tail = makeRandomKeyword(rng, rng() % 20, 26);
+		string a = stem + makeRandomKeyword(rng, rng() % 6, 3) + tail;
+		string b = stem + makeRandomKeyword(rng, rng() % 6, 3) + tail;
+		if (a.empty() || a.size() > 64)
+			continue;
+		int full = levenshtein(a, b);
+		int max_dist = rng() % 8;
+		MatchProfile profile = buildMatchProfile(a);
+		EXPECT_EQ(levenshteinBounded(a, b, max_dist), std::min(full, max_dist + 1)) << a << " / " << b;
+		EXPECT_EQ(std::min(myersDistanceProfileTrimmed(profile, a, b, max_dist), max_dist + 1),
+			std::min(full, max_dist + 1)) << a << " / " << b;
+		EXPECT_EQ(myersDistanceProfileTrimmed(profile, a, b, 1000), full) << a << " / " << b;
+	}
+}
+
+TEST(ScorerTest, FindNearestMatchesBruteForce) {
+	std::mt19937 rng(12);
+	for (int iter = 0; iter < 1000; iter++) {
+		string query = makeRandomKeyword(rng, rng() % 16, 4);
+		std::vector<Node2> candidates;
+		for (int c = 0; c < 12; c++) {
+			candidates.push_back({ mutateKeyword(rng, query, rng() % 5, 4), c });
+		}
+		size_t k = 1 + rng() % 4;
+
+		std::vector<SimilarKeyword> expected;
+		for (const Node2& candidate : candidates) {
+			int score = g_levenshteinScorer.score(candidate.name.str(), query);
+			bool seen = false;
+			for (const SimilarKeyword& e : expected)
+				seen = seen || candidate.name == e.name;
+			if (score >= SIMILAR_THRESHOLD && !seen)
+				expected.push_back({ candidate.name.str(), score });
+		}
+		std::stable_sort(expected.begin(), expected.end(),
+			[](const SimilarKeyword& x, const SimilarKeyword& y) { return x.score > y.score; });
+		if (expected.size() > k)
+			expected.resize(k);
+
+		std::vector<SimilarKeyword> fast, slow;
+		SimilarityEngine<BitParallelPolicy>::findNearest(query, candidates, k, SIMILAR_THRESHOLD, fast);
+		g_levenshteinScorer.findNearest(query, candidates, k, SIMILAR_THRESHOLD, slow);
+		ASSERT_EQ(fast.size(), expected.size());
+		ASSERT_EQ(slow.size(), expected.size());
+		for (size_t i = 0; i < expected.size(); i++) {
+			EXPECT_EQ(fast[i].name, expected[i].name);
+			EXPECT_EQ(fast[i].score, expected[i].score);
+			EXPECT_EQ(slow[i].name, expected[i].name);
+		}
+	}
+}
+
+TEST(KeywordTest, NearestKeywordsPreferCloserMatch) {
+	RankStateGuard guard;
+	// ù ° ׸    ° ׸  
+	DayBest[2] = { { "abcdefgxyz", 1 }, { "abcdefghij", 2 } };
+	twoBest[0] = { { "abcdefghij", 2 } };
+	rankListReplaced(2);
+	rankListReplaced(7);
+
+	vector<SimilarKeyword> nearest = findNearestKeywords("abcdefghiz", "wednesday", 5);
+	ASSERT_EQ(nearest.size(), 2u);
+	EXPECT_EQ(nearest[0].name, "abcdefghij");
+	EXPECT_EQ(nearest[0].score, 90);
+	EXPECT_EQ(nearest[1].name, "abcdefgxyz");
+	EXPECT_EQ(nearest[1].score, 80);
+	EXPECT_EQ(findNearestKeywords("abcdefghiz", "wednesday", 1).size(), 1u);
+	EXPECT_TRUE(findNearestKeywords("abcdefghiz", "someday", 3).empty());
+
+	//  ù ° ġ  ״
+	EXPECT_EQ(findSimilarIndex("abcdefghiz", DayBest[2]), 0);
+}
+
+TEST(ScorerTest, OsaCountsTranspositionOnce) {
+	EXPECT_EQ(osaDistance("banana", "bnaana"), 1);
+	EXPECT_EQ(levenshtein("banana", "bnaana"), 2);
+	EXPECT_EQ(osaDistance("ca", "abc"), 3);           // OSA ġ κ ٽ  
+	EXPECT_EQ(osaBounded("ca", "abc", 5), 3);
+	EXPECT_EQ(g_osaScorer.score("banana", "bnaana"), 83);
+	EXPECT_EQ(g_levenshteinScorer.score("banana", "bnaana"), 67);
+	EXPECT_TRUE(g_osaScorer.isSimilar("banana", "bnaana", SIMILAR_THRESHOLD));
+	EXPECT_FALSE(g_levenshteinScorer.isSimilar("banana", "bnaana", SIMILAR_THRESHOLD));
+	EXPECT_FALSE(g_osaScorer.isSimilar("banana", "apple", SIMILAR_THRESHOLD));
+}
+
+//  ġ  
+string transposeKeyword(std::mt19937& rng, string s, int swaps) {
+	for (int i = 0; i < swaps && s.size() >= 2; i++) {
+		size_t pos = rng() % (s.size() - 1);
+		std::swap(s[pos], s[pos + 1]);
+	}
+	return s;
+}
+
+TEST(ScorerTest, OsaKernelsMatchFullDistance) {
+	std::mt19937 rng(15);
+	for (int iter = 0; iter < 3000; iter++) {
+		size_t len = (iter % 3 == 0) ? 60 + rng() % 100 : rng() % 20;
+		string a = makeRandomKeyword(rng, len, 4);
+		string b = transposeKeyword(rng, mutateKeyword(rng, a, rng() % 4, 4), rng() % 4);
+		const int expected = osaDistance(a, b);
+		const int max_dist = static_cast<int>(rng() % 12);
+		EXPECT_EQ(osaBoundedRaw(a.data(), static_cast<int>(a.size()), b.data(), static_cast<int>(b.size()), max_dist),
+			std::min(expected, max_dist + 1)) << a << " / " << b;
+		EXPECT_EQ(osaBounded(a, b, max_dist), std::min(expected, max_dist + 1)) << a << " / " << b;
+		EXPECT_EQ(osaBounded(a, b, static_cast<int>(std::max(a.size(), b.size()))), expected);
+
+		const int full_max = maxDistanceFor(std::max(a.size(), b.size()), SIMILAR_THRESHOLD);
+		if (!a.empty() && !b.empty() && a != b) {
+			EXPECT_EQ(g_osaScorer.isSimilar(a, b, SIMILAR_THRESHOLD), full_max >= 0 && expected <= full_max) << a << " / " << b;
+		}
+	}
+}
+
+TEST(ScorerTest, OsaEngineMatchesFullDistance) {
+	std::mt19937 rng(151);
+	for (int iter = 0; iter < 400; iter++) {
+		std::vector<Node2> candidates;
+		std::vector<string> names;
+		for (int c = 0; c < 6; c++) {
+			size_t len = (c == 5) ? 70 + rng() % 40 : 4 + rng() % 20;
+			names.push_back(makeRandomKeyword(rng, len, 6));
+			candidates.push_back({ names.back(), c });
+		}
+		const string query = transposeKeyword(rng, mutateKeyword(rng, names[rng() % 6], rng() % 3, 6), rng() % 3);
+
+		int expected = -1;
+		for (size_t i = 0; i < names.size() && expected < 0; i++) {
+			const int full_max = maxDistanceFor(std::max(names[i].size(), query.size()), SIMILAR_THRESHOLD);
+			if (full_max >= 0 && osaDistance(names[i], query) <= full_max)
+				expected = static_cast<int>(i);
+		}
+		EXPECT_EQ(g_osaScorer.findFirstSimilar(query, candidates, SIMILAR_THRESHOLD), expected) << query;
+	}
+
+	// OSA scorer ġϸ findSimilarIndex OSA  η 
+	const ISimilarityScorer* saved = g_scorer;
+	setSimilarityScorer(&g_osaScorer);
+	std::vector<Node2> list = { { "banana", 1 }, { "strawberry", 2 } };
+	EXPECT_EQ(findSimilarIndex("strawbrery", list), 1);
+	EXPECT_EQ(findSimilarIndex("apple", list), -1);
+	setSimilarityScorer(saved);
+}
+
+TEST(ScorerTest, SwitchScorer) {
+	const ISimilarityScorer* saved = g_scorer;
+	setSimilarityScorer(&g_levenshteinScorer);
+	EXPECT_TRUE(similer("banana", "bananas"));
+	EXPECT_FALSE(similer("banana", "apple"));
+	setSimilarityScorer(&g_bitParallelScorer);
+	EXPECT_TRUE(similer("banana", "bananas"));
+	EXPECT_FALSE(similer("banana", "apple"));
+	setSimilarityScorer(saved);
+}
+
+TEST(KeywordTest, InternTableSharesAndRecyclesIds) {
+	static_assert(sizeof(Node2) == 8, "Node2 holds only keyword id and point");
+	const size_t live_before = g_keywords.size();
+	{
+		Node2 a = { "intern-shared", 1 };
+		Node2 b = { string("intern-shared"), 2 };
+		EXPECT_EQ(a.name.id(), b.name.id());
+		EXPECT_EQ(g_keywords.find("intern-shared"), a.name.id());
+		EXPECT_EQ(a.name, "intern-shared");
+		EXPECT_EQ(g_keywords.size(), live_before + 1);
+	}
+	//   ȸ 
+	EXPECT_EQ(g_keywords.find("intern-shared"), kNoKeyword);
+	EXPECT_EQ(g_keywords.size(), live_before);
+
+	//  Ű带 ְ   Ű ״ ȸ (backward-shift , arena )
+	std::mt19937 rng(16);
+	std::vector<InternedKeyword> kept;
+	for (int round = 0; round < 20; round++) {
+		std::vector<InternedKeyword> temp;
+		for (int i = 0; i < 500; i++)
+			temp.push_back(makeRandomKeyword(rng, 5 + rng() % 40, 26) + std::to_string(round));
+		for (size_t i = 0; i < temp.size(); i += 50)
+			kept.push_back(temp[i]);
+	}
+	EXPECT_EQ(g_keywords.size(), live_before + kept.size());
+	EXPECT_LT(g_keywords.arenaBytes(), 20u * 500u * 20u);
+	for (const InternedKeyword& keyword : kept)
+		EXPECT_EQ(g_keywords.find(keyword.str()), keyword.id());
+}
+
+TEST(KeywordTest, RankIndexMatchesLinearScan) {
+	RankIndex index;
+	std::map<uint32_t, int> expected;
+	std::mt19937 rng(17);
+	for (int step = 0; step < 20000; step++) {
+		// ؽð   Ʈ ٸ
+		uint32_t id = rng() % 300;
+		uint64_t hash = (id % 7) * 0x100000000ull + (id % 5);
+		if (rng() % 3 == 0) {
+			index.erase(id, hash);
+			expected.erase(id);
+		}
+		else {
+			int slot = static_cast<int>(rng() % 1000);
+			index.assign(id, hash, slot);
+			expected[id] = slot;
+		}
+		if (step % 97 == 0) {
+			for (uint32_t probe = 0; probe < 300; probe++) {
+				auto it = expected.find(probe);
+				uint64_t probe_hash = (probe % 7) * 0x100000000ull + (probe % 5);
+				EXPECT_EQ(index.find(probe, probe_hash), it == expected.end() ? -1 : it->second);
+			}
+		}
+	}
+	EXPECT_EQ(index.size(), expected.size());
+}
+
+TEST(KeywordTest, RankSlotLookupIgnoresTies) {
+	RankStateGuard guard;
+	setRankCapacity(300);
+	DayBest[4].clear();
+	for (int i = 0; i < 200; i++)
+		DayBest[4].push_back({ "tie" + std::to_string(i * 7919), 2100000000 });
+	rankListReplaced(4);
+
+	// point  Ƶ  ġ ٷ 
+	for (size_t slot = 0; slot < DayBest[4].size(); ++slot)
+		EXPECT_EQ(findRankSlot(DayBest[4], DayBest[4][slot].name.id()), static_cast<int>(slot));
+
+	// ߰  и ׸  ġ
+	addKeyword(DayBest[4], "tie-low", 5);
+	ASSERT_EQ(DayBest[4].size(), 201u);
+	EXPECT_EQ(DayBest[4][0].name, "tie-low");
+	for (size_t slot = 0; slot < DayBest[4].size(); ++slot)
+		EXPECT_EQ(findRankSlot(DayBest[4], DayBest[4][slot].name.id()), static_cast<int>(slot));
+}
+
+TEST(KeywordTest, PerfectHitAfterEviction) {
+	RankStateGuard guard;
+	guard.clear(5);
+	guard.clear(8);
+
+	//    Ű    ü
+	std::vector<string> words;
+	for (int i = 0; i < 30; i++)
+		words.push_back(string(1, static_cast<char>('A' + i % 26)) + std::to_string(i * 7919));
+	for (const string& word : words)
+		updateKeywordBy(word, "saturday");
+
+	for (const Node2& node : DayBest[5]) {
+		int slot = findRankSlot(DayBest[5], node.name.id());
+		ASSERT_GE(slot, 0);
+		EXPECT_EQ(DayBest[5][slot].name.id(), node.name.id());
+	}
+	EXPECT_EQ(g_rankIndex[5].size(), DayBest[5].size());
+	EXPECT_EQ(findRankSlot(DayBest[5], g_keywords.find("not-in-list")), -1);
+
+	int before = DayBest[5][findRankSlot(DayBest[5], g_keywords.find(DayBest[5][3].name.str()))].point;
+	string hit = DayBest[5][3].name.str();
+	EXPECT_EQ(updateKeywordBy(hit, "saturday"), hit);
+	EXPECT_GT(DayBest[5][3].point, before);
+}
+
+bool isRankOrdered(const std::vector<Node2>& list) {
+	for (size_t i = 1; i < list.size(); i++) {
+		if (list[i].point < list[i - 1].point)
+			return false;
+	}
+	return true;
+}
+
+//   top-K Ȯ
+//  ׸ hits   ġ ̰,  ۿ HIT Ű    ּڰ  
+::testing::AssertionResult isTopKOfTier(int list_id, const std::vector<string>& words) {
+	const std::vector<Node2>& list = rankList(list_id);
+	const RankColumns& columns = g_rankColumns[list_id];
+	uint32_t lowest = 0xFFFFFFFFu;
+	for (size_t slot = 0; slot < list.size(); ++slot) {
+		const uint32_t estimate = g_heavyHitters[list_id].estimate(list[slot].name.hash());
+		if (columns.tierGeneration == g_heavyHitters[list_id].generation() && columns.hits[slot] > estimate)
+			return ::testing::AssertionFailure() << list[slot].name << " hits " << columns.hits[slot] << " > " << estimate;
+		lowest = std::min(lowest, estimate);
+	}
+	if (list.size() < g_rankCapacity)
+		lowest = 0;
+	for (const string& word : words) {
+		const uint32_t estimate = g_heavyHitters[list_id].estimate(hashKeyword(word));
+		if (findRankSlot(list, g_keywords.find(word)) < 0 && estimate > lowest && list.size() == g_rankCapacity)
+			return ::testing::AssertionFailure() << word << " (" << estimate << ") outranks the list minimum " << lowest;
+		if (findRankSlot(list, g_keywords.find(word)) < 0 && estimate > 0 && list.size() < g_rankCapacity)
+			return ::testing::AssertionFailure() << word << " was counted but not admitted to a list with room";
+	}
+	return ::testing::AssertionSuccess();
+}
+
+TEST(KeywordTest, IncreaseNodePointClampsWithoutOverflow) {
+	EXPECT_EQ(increaseNodePoint(100), 110);
+	EXPECT_EQ(increaseNodePoint(1952257861), 2100000000);
+	EXPECT_EQ(increaseNodePoint(2051460649), 2100000000);
+	EXPECT_EQ(increaseNodePoint(2100000000), 2100000000);
+}
+
+TEST(KeywordTest, RankOrderSurvivesHitsAndEvictions) {
+	RankStateGuard guard;
+	guard.clear();
+
+	//  ֿ ݺ HIT  Ű  
+	const char* days[] = { "monday", "tuesday", "wednesday", "thursday", "friday", "saturday", "sunday" };
+	std::vector<string> words;
+	for (int i = 0; i < 40; i++)
+		words.push_back(string(1, static_cast<char>('A' + i % 26)) + std::to_string(i * 7919));
+	std::mt19937 rng(24);
+	for (int step = 0; step < 3000; step++) {
+		const string& word = words[(rng() % 3 == 0) ? rng() % 40 : rng() % 12];
+		const int day = static_cast<int>(rng() % 7);
+		const int weekend = (day < 5) ? 0 : 1;
+		updateKeywordBy(word, days[day]);
+
+		ASSERT_TRUE(isRankOrdered(DayBest[day])) << "step " << step;
+		ASSERT_TRUE(isRankOrdered(twoBest[weekend])) << "step " << step;
+		ASSERT_EQ(g_rankIndex[day].size(), DayBest[day].size());
+		for (size_t slot = 0; slot < DayBest[day].size(); ++slot) {
+			const Node2& node = DayBest[day][slot];
+			ASSERT_EQ(g_rankIndex[day].find(node.name.id(), node.name.hash()), static_cast<int>(slot));
+			ASSERT_EQ(g_rankColumns[day].hashes[slot], node.name.hash());
+			ASSERT_EQ(g_rankColumns[day].lengths[slot], node.name.size());
+		}
+		//   top-K ( HIT ٸ  Ͽ  Ű )
+		ASSERT_TRUE(isTopKOfTier(day, words)) << "step " << step;
+		ASSERT_TRUE(isTopKOfTier(7 + weekend, words)) << "step " << step;
+	}
+}
+
+TEST(KeywordTest, TopKViewReadsInternedNames) {
+	RankStateGuard guard;
+	guard.clear();
+
+	for (int i = 0; i < 12; i++)
+		updateKeywordBy(string(1, static_cast<char>('a' + i)) + std::to_string(i * 7919), "wednesday");
+	updateKeywordBy("c15838", "wednesday");
+
+	RankView top = topK("wednesday");
+	ASSERT_EQ(top.size(), 10u);
+	EXPECT_FALSE(top.stale());
+	EXPECT_EQ(top[0].name, string("c15838"));
+	for (size_t rank = 0; rank < top.size(); rank++) {
+		const Node2& node = DayBest[2][DayBest[2].size() - 1 - rank];
+		EXPECT_EQ(top[rank].name.data(), node.name.text().data());
+		EXPECT_EQ(top[rank].point, node.point);
+		if (rank > 0) {
+			EXPECT_GE(top[rank - 1].point, top[rank].point);
+		}
+	}
+	EXPECT_EQ(topK("wednesday", 3).size(), 3u);
+	EXPECT_EQ(topK("weekday")[0].name, string("c15838"));
+	EXPECT_TRUE(topK("holiday").empty());
+	EXPECT_TRUE(topK("holiday").stale());
+
+	// ٸ    ,   ٲ stale
+	// (̹ intern Ű带 Ἥ arena Ű ʰ )
+	const uint64_t version = rankVersion("wednesday");
+	EXPECT_EQ(version, top.version());
+	updateKeywordBy("c15838", "saturday");
+	EXPECT_FALSE(top.stale());
+	updateKeywordBy("c15838", "wednesday");
+	EXPECT_TRUE(top.stale());
+	EXPECT_NE(rankVersion("wednesday"), version);
+
+	// ȸ б  Ҵ 
+	const string wednesday = "wednesday";
+	long long before = allocationCount();
+	long long total = 0;
+	for (int i = 0; i < 100; i++) {
+		RankView view = topK(wednesday);
+		for (size_t rank = 0; rank < view.size(); rank++)
+			total += view[rank].point + static_cast<long long>(view[rank].name.size());
+	}
+	EXPECT_EQ(allocationCount() - before, 0);
+	EXPECT_GT(total, 0);
+
+}
+
+TEST(KeywordTest, TopKViewStaleAfterArenaMove) {
+	RankStateGuard guard;
+	guard.clear();
+
+	for (int i = 0; i < 5; i++)
+		updateKeywordBy("arena" + std::to_string(i * 7919), "thursday");
+
+	RankView view = topK("thursday");
+	EXPECT_FALSE(view.stale());
+	EXPECT_EQ(view.version() % 2, 0u);
+	// ٸ  纻   ù Խÿ 
+	rankSnapshot("thursday", 3);
+	publishRankSnapshots();
+	const RankSnapshotPtr snapshot = rankSnapshot("thursday", 3);
+	ASSERT_GE(snapshot->size(), 3u);
+	EXPECT_EQ(snapshot->version(), view.version());
+	for (size_t rank = 0; rank < 3; rank++) {
+		const RankEntry entry = (*snapshot)[rank];
+		EXPECT_TRUE(view[rank].name == string(entry.name.begin(), entry.name.end()));
+		EXPECT_EQ(view[rank].point, entry.point);
+	}
+	EXPECT_TRUE(rankSnapshot("holiday", 3)->empty());
+	const string top = DayBest[3].back().name.str();
+
+	//  ״ο  Ű intern /  arena Ű view stale,  ּҴ  
+	const uint64_t storage = g_keywords.storageVersion();
+	for (int i = 0; g_keywords.storageVersion() == storage && i < 100000; i++)
+		InternedKeyword filler("arena-filler-" + std::to_string(i) + string(64, 'x'));
+	EXPECT_NE(g_keywords.storageVersion(), storage);
+	EXPECT_EQ(rankVersion("thursday"), view.version());
+	EXPECT_TRUE(view.stale());
+	EXPECT_TRUE(view[0].name.empty());
+
+	// 纻 ڱ ۸ ŰǷ  ȿϰ, ٽ  view  ġ Ŵ
+	EXPECT_TRUE((*snapshot)[0].name == top);
+	view = topK("thursday");
+	EXPECT_FALSE(view.stale());
+	EXPECT_TRUE(view[0].name == top);
+
+}
+
+TEST(KeywordTest, RankCapacityRuntime) {
+	RankStateGuard guard;
+	guard.clear(0);
+	setRankCapacity(100);
+	for (int i = 0; i < 150; i++) {
+		string name = "cap" + std::to_string(i * 7919);
+		addKeyword(DayBest[0], name, 1000 + (i * 37) % 150);
+	}
+	EXPECT_EQ(DayBest[0].size(), 100u);
+	for (size_t i = 1; i < DayBest[0].size(); i++)
+		EXPECT_LE(DayBest[0][i - 1].point, DayBest[0][i].point);
+
+	// ̸ point  ׸ 
+	int top = DayBest[0].back().point;
+	setRankCapacity(10);
+	EXPECT_EQ(DayBest[0].size(), 10u);
+	EXPECT_EQ(DayBest[0].back().point, top);
+	for (const Node2& node : DayBest[0])
+		EXPECT_EQ(findRankSlot(DayBest[0], node.name.id()) >= 0, true);
+}
+
+TEST(KeywordTest, EvictsLowestPoint) {
+	std::vector<Node2> list;
+	RankIndex index;
+	for (int i = 0; i < 10; i++)
+		insertRanked(list, 10, "evict" + std::to_string(i), 100 + i * 10, &index);
+	ASSERT_EQ(list.size(), 10u);
+	EXPECT_EQ(list.front().name, "evict0");
+
+	//   ׸񺸴   
+	EXPECT_EQ(insertRanked(list, 10, "too-low", 50, &index), -1);
+	EXPECT_EQ(index.find(g_keywords.find("evict0"), hashKeyword("evict0")), 0);
+
+	// ߰ point   ׸   ° 
+	EXPECT_EQ(insertRanked(list, 10, "middle", 145, &index), 4);
+	EXPECT_EQ(list.front().name, "evict1");
+	EXPECT_EQ(list[4].name, "middle");
+	EXPECT_EQ(list[5].name, "evict5");
+	EXPECT_EQ(index.find(g_keywords.find("evict0"), hashKeyword("evict0")), -1);
+	EXPECT_EQ(index.find(list[4].name.id(), hashKeyword("middle")), 4);
+	EXPECT_EQ(index.size(), 10u);
+	for (size_t i = 0; i < list.size(); i++)
+		EXPECT_EQ(index.find(list[i].name.id(), list[i].name.hash()), static_cast<int>(i));
+	for (size_t i = 1; i < list.size(); i++)
+		EXPECT_LE(list[i - 1].point, list[i].point);
+}
+
+TEST(KeywordTest, CountMinBounds) {
+	static CountMinSketch tier;
+	tier.clear();
+	EXPECT_EQ(tier.add(hashKeyword("first"), 3), 3u);
+	EXPECT_EQ(tier.estimate(hashKeyword("never-seen")), 0u);
+	tier.clear();
+	std::map<uint64_t, uint32_t> truth;
+	std::mt19937 rng(21);
+	for (int i = 0; i < 100000; i++) {
+		// Ҽ Ű尡 κ ϴ  +  ȸ Ű
+		uint64_t key = (rng() % 4 == 0) ? rng() % 20 : 1000 + rng() % 50000;
+		uint64_t hash = hashKeyword(std::to_string(key));
+		uint32_t weight = 1 + rng() % 3;
+		truth[hash] += weight;
+		EXPECT_GE(tier.add(hash, weight), truth[hash]);
+	}
+	// ġ  Ƚ ̻,   Ű ü 2 / width ̳  
+	const double slack = 2.0 * static_cast<double>(tier.total()) / kCountMinWidth;
+	for (const auto& entry : truth) {
+		EXPECT_GE(tier.estimate(entry.first), entry.second);
+		if (entry.second * 200.0 > tier.total()) {
+			EXPECT_LE(tier.estimate(entry.first), entry.second + slack);
+		}
+	}
+}
+
+TEST(KeywordTest, TrendingKeywordPromoted) {
+	RankStateGuard guard;
+	guard.clear(0);
+	guard.clear(7);
+
+	//  Ű  3 HIT ( 1 + Ϻ HIT 2)
+	UZ = 0;
+	const char* steady[] = { "apple", "grape", "melon", "peach", "lemon", "mango", "guava", "olive", "prune", "quince" };
+	for (int i = 0; i < 10; i++) {
+		string name = steady[i];
+		addKeyword(DayBest[0], name, 1000 + i * 100);
+		addKeyword(twoBest[0], name, 1000 + i * 100);
+	}
+	for (int hit = 0; hit < 2; hit++) {
+		for (const char* name : steady)
+			EXPECT_EQ(updateKeywordBy(name, "monday"), name);
+	}
+	EXPECT_EQ(g_heavyHitters[0].estimate(DayBest[0][0].name.hash()), 3u);
+	EXPECT_EQ(g_rankColumns[0].hits[0], 3u);
+
+	// point(UZ)δ  ϴ Ű:   3 HIT Ű带 о  ( Ƚ point )
+	const string trend = "zucchini";
+	for (int i = 0; i < 3; i++) {
+		updateKeywordBy(trend, "monday");
+		EXPECT_EQ(findRankSlot(DayBest[0], g_keywords.find(trend)), -1);
+	}
+	EXPECT_EQ(g_heavyHitters[0].estimate(hashKeyword(trend)), 3u);
+
+	// 4° HIT ġ(4)  ּڰ(3) Ѿ,  point   apple  
+	//   point ̹Ƿ UZ point  trend  Ʒ
+	updateKeywordBy(trend, "monday");
+	const int slot = findRankSlot(DayBest[0], g_keywords.find(trend));
+	ASSERT_EQ(slot, 0);
+	EXPECT_EQ(DayBest[0][0].point, UZ);
+	EXPECT_EQ(g_rankColumns[0].hits[0], 4u);
+	EXPECT_EQ(findRankSlot(DayBest[0], g_keywords.find("apple")), -1);
+	EXPECT_TRUE(isTopKOfTier(0, { trend, "apple", "grape" }));
+}
+
+TEST(KeywordTest, TierCountOverridesPointOrder) {
+	RankStateGuard guard;
+	guard.clear(6);
+
+	// point     Ű  ä
+	for (int i = 0; i < 10; i++)
+		addKeyword(DayBest[6], "sunday" + std::to_string(i * 7919), 5000 + i * 10);
+	const string lowest_name = DayBest[6][0].name.str();
+
+	// UZ point(101, 102)δ   ׸(5000)   HIT Ƚ 2° 
+	UZ = 100;
+	const string riser = "sunday-riser";
+	addKeyword(DayBest[6], riser, ++UZ);
+	EXPECT_EQ(findRankSlot(DayBest[6], g_keywords.find(riser)), -1);
+	addKeyword(DayBest[6], riser, ++UZ);
+	ASSERT_EQ(findRankSlot(DayBest[6], g_keywords.find(riser)), 0);
+	EXPECT_EQ(DayBest[6][0].point, 102);
+	EXPECT_EQ(findRankSlot(DayBest[6], g_keywords.find(lowest_name)), -1);
+	EXPECT_EQ(DayBest[6].size(), 10u);
+
+	//    point  Ƶ HIT 1 ׸ (2 HIT riser )
+	addKeyword(DayBest[6], "sunday-second", ++UZ);
+	addKeyword(DayBest[6], "sunday-second", ++UZ);
+	EXPECT_GE(findRankSlot(DayBest[6], g_keywords.find(riser)), 0);
+	EXPECT_GE(findRankSlot(DayBest[6], g_keywords.find("sunday-second")), 0);
+}
+
+//  ȸ Ű尡   HIT Ű ڸ Ŵ ( ȭ  ѱ )
+TEST(KeywordTest, TierKeepsHeavyHittersUnderOneOffFlood) {
+	RankStateGuard guard;
+	guard.clear(5);
+
+	std::vector<string> popular;
+	for (int i = 0; i < 10; i++)
+		popular.push_back("popular" + std::to_string(i));
+	for (int hit = 0; hit < 30; hit++) {
+		for (const string& name : popular)
+			addKeyword(DayBest[5], name, 9);
+	}
+	const unsigned generation = g_heavyHitters[5].generation();
+	const int flood = static_cast<int>(kCountMinSampleSize) + 100000;
+	for (int i = 0; i < flood; i++)
+		addKeyword(DayBest[5], "once" + std::to_string(i), 9);
+	EXPECT_NE(g_heavyHitters[5].generation(), generation);
+
+	ASSERT_EQ(DayBest[5].size(), 10u);
+	for (const string& name : popular)
+		EXPECT_GE(findRankSlot(DayBest[5], g_keywords.find(name)), 0) << name;
+}
+
+// resetScore()      ,     
+TEST(KeywordTest, TierAgesWithScoreReset) {
+	RankStateGuard guard;
+	guard.clear(4);
+	const string name = "aging-keyword";
+	for (int hit = 0; hit < 8; hit++)
+		addKeyword(DayBest[4], name, 9);
+	EXPECT_EQ(g_heavyHitters[4].estimate(hashKeyword(name)), 8u);
+
+	resetScore();
+	EXPECT_EQ(g_heavyHitters[4].estimate(hashKeyword(name)), 8u);
+	syncScoreGeneration(4);
+	EXPECT_EQ(g_heavyHitters[4].estimate(hashKeyword(name)), 4u);
+
+	setScoreMode(ScoreMode::Decay, 10);
+	EXPECT_EQ(g_heavyHitters[4].estimate(hashKeyword(name)), 0u);
+	EXPECT_EQ(g_heavyHitters[4].total(), 0u);
+}
+
+//  HIT ã Ű HIT ࿡ 
+TEST(KeywordTest, SimilarHitCountsInTier) {
+	RankStateGuard guard;
+	guard.clear(2);
+	guard.clear(7);
+	const string exact = "watermelon";
+	EXPECT_EQ(updateKeywordBy(exact, "wednesday"), exact);
+	EXPECT_EQ(g_heavyHitters[2].estimate(hashKeyword(exact)), 1u);
+	EXPECT_EQ(g_heavyHitters[7].estimate(hashKeyword(exact)), 1u);
+
+	EXPECT_EQ(updateKeywordBy("watermelons", "wednesday"), exact);
+	EXPECT_EQ(updateKeywordBy("watermelom", "wednesday"), exact);
+	EXPECT_EQ(g_heavyHitters[2].estimate(hashKeyword(exact)), 3u);
+	EXPECT_EQ(g_heavyHitters[7].estimate(hashKeyword(exact)), 3u);
+	EXPECT_EQ(g_heavyHitters[2].estimate(hashKeyword("watermelons")), 0u);
+	const int slot = findRankSlot(DayBest[2], g_keywords.find(exact));
+	ASSERT_GE(slot, 0);
+	EXPECT_EQ(g_rankColumns[2].hits[slot], 3u);
+	EXPECT_EQ(DayBest[2].size(), 1u);
 }
 
-TEST(KeywordTest, EmptyKeyword2) {
-	string keyword = "";
-	string day = "tuesday";
-	string result = updateKeywordBy(keyword, day);
-	EXPECT_EQ(result, keyword);
+TEST(KeywordTest, SimilarityMemoHitsAndInvalidation) {
+	RankStateGuard guard;
+	guard.clear(3);
+	string a = "memo-keyword-alpha", b = "memo-keyword-beta";
+	addKeyword(DayBest[3], a, 10);
+	addKeyword(DayBest[3], b, 20);
+
+	SimilarityMemoStats before = g_similarityMemoStats;
+	EXPECT_EQ(findSimilarIndex("memo-keyword-betta", DayBest[3]), 1);
+	EXPECT_EQ(g_similarityMemoStats.hits, before.hits);
+	EXPECT_EQ(g_similarityMemoStats.misses, before.misses + 2);
+
+	//  Ǵ Ÿ   ޸𿡼  
+	EXPECT_EQ(findSimilarIndex("memo-keyword-betta", DayBest[3]), 1);
+	EXPECT_EQ(g_similarityMemoStats.hits, before.hits + 2);
+	EXPECT_EQ(findSimilarIndex("unrelated", DayBest[3]), -1);
+	EXPECT_EQ(g_similarityMemoStats.hits, before.hits + 2);
+
+	//  ٲ ش   ٽ 
+	uint32_t other_generation = g_listGeneration[4];
+	string c = "memo-keyword-gamma";
+	addKeyword(DayBest[3], c, 30);
+	EXPECT_EQ(g_listGeneration[4], other_generation);
+	SimilarityMemoStats after_add = g_similarityMemoStats;
+	EXPECT_EQ(findSimilarIndex("memo-keyword-betta", DayBest[3]), 1);
+	EXPECT_EQ(g_similarityMemoStats.hits, after_add.hits);
+
+	// scorer ü ȿȭ
+	const ISimilarityScorer* saved = g_scorer;
+	setSimilarityScorer(&g_levenshteinScorer);
+	SimilarityMemoStats after_switch = g_similarityMemoStats;
+	EXPECT_EQ(findSimilarIndex("memo-keyword-betta", DayBest[3]), 1);
+	EXPECT_EQ(g_similarityMemoStats.hits, after_switch.hits);
+	setSimilarityScorer(saved);
 }
 
-TEST(KeywordTest, 2weeksInput) {
-	string keyword = "a";
-	string day = "monday";
-	updateKeywordBy(keyword, day);
-	string result = updateKeywordBy(keyword, day); 
-	EXPECT_EQ(result, keyword);
+TEST(KeywordTest, NegativeCacheSkipsRepeatedMiss) {
+	RankStateGuard guard;
+	guard.clear(4);
+	for (int i = 0; i < 10; i++) {
+		string name = "negative-" + std::to_string(i);
+		addKeyword(DayBest[4], name, 100 + i);
+	}
 
-	keyword = "b";
-	day = "tuesday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day); 
-	EXPECT_EQ(result, keyword);
+	SimilarityMemoStats before = g_similarityMemoStats;
+	EXPECT_EQ(findSimilarIndex("completely different", DayBest[4]), -1);
+	EXPECT_EQ(g_similarityMemoStats.negativeStores, before.negativeStores + 1);
 
-	keyword = "c";
-	day = "wednesday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day); 
-	EXPECT_EQ(result, keyword);
+	// ݺ miss ĺ  
+	SimilarityMemoStats second = g_similarityMemoStats;
+	EXPECT_EQ(findSimilarIndex("completely different", DayBest[4]), -1);
+	EXPECT_EQ(g_similarityMemoStats.negativeHits, second.negativeHits + 1);
+	EXPECT_EQ(g_similarityMemoStats.lookups, second.lookups);
 
-	keyword = "d";
-	day = "thursday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day); 
-	EXPECT_EQ(result, keyword);
+	//    ״θ ĳ 
+	string low = "low";
+	addKeyword(DayBest[4], low, 1);
+	EXPECT_EQ(findSimilarIndex("completely different", DayBest[4]), -1);
+	EXPECT_EQ(g_similarityMemoStats.negativeHits, second.negativeHits + 2);
 
-	keyword = "e";
-	day = "friday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day); 
-	EXPECT_EQ(result, keyword);
+	//  ٲ ٽ Žؼ  ׸ ã
+	string added = "completely differentt";
+	addKeyword(DayBest[4], added, 1000);
+	EXPECT_GE(findSimilarIndex("completely different", DayBest[4]), 0);
+	EXPECT_EQ(g_similarityMemoStats.negativeHits, second.negativeHits + 2);
+}
 
-	keyword = "f";
-	day = "saturday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day); 
-	EXPECT_EQ(result, keyword);
+TEST(KeywordTest, DecayModeNeverResets) {
+	RankStateGuard guard;
 
-	keyword = "g";
-	day = "sunday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day); 
-	EXPECT_EQ(result, keyword);
+	// 2100000000°  αٿ UZ ٸ  ״
+	g_scoreClock = 2000000000;
+	setScoreMode(ScoreMode::Decay, 1000);
+	UZ = 12345;
+	std::vector<Node2> tuesday = DayBest[1];
+	updateKeywordBy("overflow-check", "monday");
+	EXPECT_EQ(UZ, 12345);
+	EXPECT_EQ(g_scoreClock, 2000000001);
+	ASSERT_EQ(DayBest[1].size(), tuesday.size());
+	for (size_t i = 0; i < tuesday.size(); i++)
+		EXPECT_EQ(DayBest[1][i].point, tuesday[i].point);
+}
 
+TEST(KeywordTest, DecayModePrefersRecentHits) {
+	RankStateGuard guard;
+	const int savedUZ = UZ;
 
+	g_scoreClock = 0;
+	setScoreMode(ScoreMode::Decay, 10);
+	for (int i = 0; i < 5; i++)
+		updateKeywordBy("alpha", "monday");
+	for (int i = 0; i < 60; i++)
+		updateKeywordBy("q" + std::to_string(i * 7919), "tuesday");
+	updateKeywordBy("omega", "monday");
+	updateKeywordBy("omega", "monday");
 
+	int alpha = findRankSlot(DayBest[0], g_keywords.find("alpha"));
+	int omega = findRankSlot(DayBest[0], g_keywords.find("omega"));
+	ASSERT_GE(alpha, 0);
+	ASSERT_GE(omega, 0);
+	EXPECT_LT(alpha, omega);
 
-	keyword = "a";
-	day = "monday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day); 
-	EXPECT_EQ(result, keyword);
+	//    谡 HIT ð հ ġ
+	double expected = 0;
+	for (int t = 1; t <= 5; t++)
+		expected += std::exp2(-(g_scoreClock - t) / 10.0);
+	EXPECT_NEAR(decayedScore(0, DayBest[0][alpha].point, g_scoreClock), expected, expected * 0.01);
+	EXPECT_NEAR(decayedScore(0, DayBest[0][omega].point, g_scoreClock), 1.0 + std::exp2(-0.1), 0.01);
+	EXPECT_EQ(UZ, savedUZ);
+}
 
-	keyword = "b";
-	day = "tuesday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day); 
-	EXPECT_EQ(result, keyword);
+TEST(KeywordTest, DecayModeRebasesPastLogCap) {
+	RankStateGuard guard;
+	guard.clear();
 
-	keyword = "c";
-	day = "wednesday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day); 
-	EXPECT_EQ(result, keyword);
+	// halfLife 10̸  log   2^21 * 10 ſ int ѿ 
+	g_scoreClock = 0;
+	setScoreMode(ScoreMode::Decay, 10);
+	const long long base = g_listLogBase[0];
+	updateKeywordBy("older", "monday");
+	for (long long jump : { 30000000LL, 3000000000LL }) {
+		g_scoreClock += jump;
+		updateKeywordBy("newer", "monday");
+		updateKeywordBy("older", "monday");
+		updateKeywordBy("newer", "monday");
+		int older = findRankSlot(DayBest[0], g_keywords.find("older"));
+		int newer = findRankSlot(DayBest[0], g_keywords.find("newer"));
+		ASSERT_GE(older, 0) << jump;
+		ASSERT_GE(newer, 0) << jump;
+		EXPECT_LT(older, newer) << jump;
+		EXPECT_LT(DayBest[0][older].point, DayBest[0][newer].point) << jump;
+		EXPECT_LT(DayBest[0][newer].point, 2100000000);
 
-	keyword = "d";
-	day = "thursday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day); 
-	EXPECT_EQ(result, keyword);
+		//  HIT  ֱ   (  )
+		updateKeywordBy("older", "monday");
+		older = findRankSlot(DayBest[0], g_keywords.find("older"));
+		newer = findRankSlot(DayBest[0], g_keywords.find("newer"));
+		EXPECT_GT(older, newer) << jump;
+		EXPECT_NEAR(decayedScore(0, DayBest[0][older].point, g_scoreClock), 1.0 + std::exp2(-0.2), 0.01);
+	}
+	EXPECT_NE(g_listLogBase[0], base);
+}
 
-	keyword = "e";
-	day = "friday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day); 
-	EXPECT_EQ(result, keyword);
+TEST(KeywordTest, DecayModeLogScoreHasNoSteps) {
+	RankStateGuard guard;
+	guard.clear(0);
 
-	keyword = "f";
-	day = "saturday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day); 
-	EXPECT_EQ(result, keyword);
+	// ݰⰡ Ҽ (1024)  ð 1ƽ log  , ݰ⸶ Ȯ 1.0
+	for (long long halfLife : { 1LL, 3LL, 10LL, 1000LL, 1024LL, 5000LL, 100000LL }) {
+		setScoreMode(ScoreMode::Decay, halfLife);
+		for (long long clock : { 0LL, 1LL, 4999LL, 123456789LL, 3000000000LL }) {
+			EXPECT_EQ(logScoreAt(clock + 1) - logScoreAt(clock), g_logScoreOne / halfLife) << halfLife;
+			EXPECT_EQ(logScoreAt(clock + halfLife) - logScoreAt(clock), g_logScoreOne) << halfLife;
+		}
+	}
 
-	keyword = "g";
-	day = "sunday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day); 
-	EXPECT_EQ(result, keyword);
+	// ӵ  ƽ  Ű   
+	g_scoreClock = 1000000;
+	setScoreMode(ScoreMode::Decay, 5000);
+	updateKeywordBy("first", "monday");
+	updateKeywordBy("second", "monday");
+	const int first = findRankSlot(DayBest[0], g_keywords.find("first"));
+	const int second = findRankSlot(DayBest[0], g_keywords.find("second"));
+	ASSERT_GE(first, 0);
+	ASSERT_GE(second, 0);
+	EXPECT_LT(DayBest[0][first].point, DayBest[0][second].point);
+	EXPECT_DOUBLE_EQ(decayedScore(0, DayBest[0][first].point, g_scoreClock + 4999), 0.5);
+}
+
+// Decay   /    :   HIT Ű嵵 ϸ  Ű忡 ڸ 
+TEST(KeywordTest, DecayModeEvictsDecayedHeavyHitters) {
+	RankStateGuard guard;
+	guard.clear(0);
+	guard.clear(7);
 
+	g_scoreClock = 0;
+	setScoreMode(ScoreMode::Decay, 10);
+	for (int i = 0; i < 50; i++)
+		updateKeywordBy("oldheavy", "monday");
+	ASSERT_EQ(findRankSlot(DayBest[0], g_keywords.find("oldheavy")), 0);
 
+	g_scoreClock += 100000;
+	const std::vector<string> fresh = { "apricot", "blueberry", "cherry", "durian", "elderberry", "fig",
+		"grapefruit", "honeydew", "kiwi", "lychee", "mulberry", "nectarine" };
+	for (const string& name : fresh)
+		EXPECT_EQ(updateKeywordBy(name, "monday"), name);
+	EXPECT_EQ(findRankSlot(DayBest[0], g_keywords.find("oldheavy")), -1);
+	ASSERT_EQ(DayBest[0].size(), 10u);
+	//  ֱٿ  10 ,  ֱϼ 
+	for (int i = 2; i < 12; i++)
+		EXPECT_EQ(findRankSlot(DayBest[0], g_keywords.find(fresh[i])), i - 2) << fresh[i];
 }
 
-TEST(KeywordTest, monday14) {
-	string keyword = "a";
-	string day = "monday";
-	updateKeywordBy(keyword, day);
-	string result = updateKeywordBy(keyword, day);
-	EXPECT_EQ(result, keyword);
+TEST(KeywordTest, ResetScoreIsLazyPerList) {
+	RankStateGuard guard;
+	for (int list_id = 0; list_id < kRankListCount; ++list_id) {
+		std::vector<Node2>& list = rankList(list_id);
+		list.clear();
+		for (int i = 0; i < 10; i++)
+			list.push_back({ "lazy" + std::to_string(list_id * 10 + i), 1000000 + i * 1000 });
+		rankListReplaced(list_id);
+	}
 
-	keyword = "b";
-	day = "monday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day);
-	EXPECT_EQ(result, keyword);
+	UZ = 2100000000;
+	updateKeywordBy("lazy3", "monday");
+	EXPECT_EQ(UZ, 9);
 
-	keyword = "c";
-	day = "monday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day);
-	EXPECT_EQ(result, keyword);
+	// ̹ ȣ   /  ϸ ٽ Ű
+	for (int i = 0; i < 10; i++) {
+		EXPECT_EQ(DayBest[0][i].point, i + 1);
+		EXPECT_EQ(DayBest[1][i].point, 1000000 + i * 1000);
+	}
+	EXPECT_EQ(DayBest[0][9].name, "lazy3");
 
-	keyword = "d";
-	day = "monday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day);
-	EXPECT_EQ(result, keyword);
+	//  Ͽ  lazy3 HIT ϵǾ,     ׸(1)  
+	// (  Ű point     UZ)
+	ASSERT_EQ(twoBest[0].size(), 10u);
+	EXPECT_EQ(findRankSlot(twoBest[0], g_keywords.find("lazy70")), -1);
+	for (int i = 0; i < 9; i++)
+		EXPECT_EQ(twoBest[0][i].point, i + 2);
+	EXPECT_EQ(twoBest[0][9].name, "lazy3");
+	EXPECT_EQ(twoBest[0][9].point, 2100000001);
 
-	keyword = "e";
-	day = "monday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day);
-	EXPECT_EQ(result, keyword);
+	// ȭ        Ű 
+	updateKeywordBy("fresh-tuesday", "tuesday");
+	ASSERT_EQ(DayBest[1].size(), 10u);
+	EXPECT_EQ(DayBest[1][0].point, 2);
+	EXPECT_EQ(DayBest[1][9].name, "fresh-tuesday");
+	EXPECT_EQ(DayBest[1][9].point, 10);
+	EXPECT_EQ(g_rankIndex[1].find(g_keywords.find("lazy19"), hashKeyword("lazy19")), 8);
+}
 
-	keyword = "f";
-	day = "monday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day);
-	EXPECT_EQ(result, keyword);
+TEST(KeywordTest, ResetScoreThenAddKeywordRenormalizes) {
+	RankStateGuard guard;
+	DayBest[2].clear();
+	for (int i = 0; i < 10; i++)
+		DayBest[2].push_back({ "direct" + std::to_string(i), 1000000 + i * 1000 });
+	rankListReplaced(2);
 
-	keyword = "g";
-	day = "monday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day);
-	EXPECT_EQ(result, keyword);
+	// updateKeywordBy ġ ʰ ٷ addKeyword,   point(1000000..) ϸ 
+	resetScore();
+	addKeyword(DayBest[2], "direct-new", UZ + 1);
+	EXPECT_EQ(g_listScoreGeneration[2], g_scoreGeneration);
+	ASSERT_EQ(DayBest[2].size(), 10u);
+	EXPECT_EQ(DayBest[2][0].name, "direct1");
+	EXPECT_EQ(DayBest[2][0].point, 2);
+	EXPECT_EQ(DayBest[2][9].name, "direct-new");
+	EXPECT_EQ(DayBest[2][9].point, 10);
+	EXPECT_EQ(findRankSlot(DayBest[2], g_keywords.find("direct9")), 8);
+}
 
+TEST(KeywordTest, RaiseAndInsertBreakTiesAlike) {
+	//  point ̿ ̵    ٲ ׸  (top-K )
+	std::vector<Node2> list = { { "low", 10 }, { "tie1", 20 }, { "tie2", 20 }, { "high", 30 } };
+	list[0].point = 20;
+	EXPECT_EQ(raiseRanked(list, 0, nullptr), 2);
+	EXPECT_EQ(list[2].name, "low");
+	EXPECT_TRUE(isRankOrdered(list));
 
+	EXPECT_EQ(insertRanked(list, 5, "inserted", 20, nullptr), 3);
+	list[0].point = 20;
+	EXPECT_EQ(raiseRanked(list, 0, nullptr), 3);
+	const char* expected[] = { "tie2", "low", "inserted", "tie1", "high" };
+	for (size_t i = 0; i < list.size(); i++)
+		EXPECT_EQ(list[i].name, expected[i]);
 
+	// ̹    point ׸ ״
+	std::vector<Node2> flat = { { "a", 7 }, { "b", 7 }, { "c", 7 } };
+	EXPECT_EQ(raiseRanked(flat, 2, nullptr), 2);
+	EXPECT_EQ(raiseRanked(flat, 0, nullptr), 2);
+	EXPECT_EQ(flat[2].name, "a");
+}
 
-	keyword = "a";
-	day = "monday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day);
-	EXPECT_EQ(result, keyword);
 
-	keyword = "b";
-	day = "monday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day);
-	EXPECT_EQ(result, keyword);
+// ٸ 尡 rankSnapshot  д   (-fsanitize=thread 忡  )
+//  HITǴ 8   ڸ  Ű尡   intern /  /  arena Ű
+TEST(KeywordTest, RankSnapshotWhileUpdating) {
+	RankStateGuard guard;
+	guard.clear();
 
-	keyword = "c";
-	day = "monday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day);
-	EXPECT_EQ(result, keyword);
+	std::atomic<bool> done{ false };
+	std::atomic<long long> reads{ 0 };
+	std::atomic<long long> broken{ 0 };
+	std::thread reader([&] {
+		uint64_t last[2] = {};
+		while (!done.load(std::memory_order_acquire)) {
+			for (int l = 0; l < 2; l++) {
+				const RankSnapshotPtr snapshot = rankSnapshot(l == 0 ? "friday" : "weekday", 10);
+				const RankSnapshot& ranks = *snapshot;
+				bool ok = ranks.size() <= 10 && ranks.version() % 2 == 0 && ranks.version() >= last[l];
+				last[l] = ranks.version();
+				for (size_t rank = 0; ok && rank < ranks.size(); rank++) {
+					const CharRange name = ranks[rank].name;
+					ok = name.size() >= 6 && std::memcmp(name.data(), "thread", 6) == 0
+						&& (rank == 0 || ranks[rank - 1].point >= ranks[rank].point);
+					for (size_t other = 0; ok && other < rank; other++)
+						ok = !(ranks[other].name == string(name.begin(), name.end()));
+				}
+				if (!ok)
+					broken.fetch_add(1, std::memory_order_relaxed);
+			}
+			reads.fetch_add(1, std::memory_order_release);
+		}
+	});
 
-	keyword = "d";
-	day = "monday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day);
-	EXPECT_EQ(result, keyword);
+	const uint64_t storage = g_keywords.storageVersion();
+	std::mt19937 rng(25);
+	for (int step = 0; step < 20000; step++) {
+		if (rng() % 2)
+			updateKeywordBy("thread" + std::to_string(rng() % 8), "friday");
+		else
+			updateKeywordBy("thread-" + makeRandomKeyword(rng, 8 + rng() % 48, 26), "friday");
+	}
+	// д   ߿   ̻   
+	while (reads.load(std::memory_order_acquire) < 2)
+		std::this_thread::yield();
+	done.store(true, std::memory_order_release);
+	reader.join();
 
-	keyword = "e";
-	day = "monday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day);
-	EXPECT_EQ(result, keyword);
+	EXPECT_EQ(broken.load(), 0);
+	EXPECT_NE(g_keywords.storageVersion(), storage);
 
-	keyword = "f";
-	day = "monday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day);
-	EXPECT_EQ(result, keyword);
+	//   Խõ 纻 ϰ 
+	rankSnapshot("friday", 10);
+	publishRankSnapshots();
+	const RankSnapshotPtr snapshot = rankSnapshot("friday", 10);
+	EXPECT_EQ(snapshot->version(), rankVersion("friday"));
+	ASSERT_EQ(snapshot->size(), DayBest[4].size());
+	for (size_t rank = 0; rank < snapshot->size(); rank++) {
+		const Node2& node = DayBest[4][DayBest[4].size() - 1 - rank];
+		EXPECT_TRUE((*snapshot)[rank].name == node.name.str());
+		EXPECT_EQ((*snapshot)[rank].point, node.point);
+	}
 
-	keyword = "g";
-	day = "monday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day);
-	EXPECT_EQ(result, keyword);
+	// ⺻  ũ⺸  ûϸ  Խú ׸ŭ Խ
+	setRankCapacity(kDefaultRankCapacity + 20);
+	for (size_t i = 0; i < kDefaultRankCapacity + 20; i++)
+		updateKeywordBy("deep-" + makeRandomKeyword(rng, 12, 26), "saturday");
+	rankSnapshot("saturday");
+	publishRankSnapshots();
+	EXPECT_EQ(rankSnapshot("saturday", kDefaultRankCapacity + 20)->size(), kDefaultRankCapacity);
+	updateKeywordBy(DayBest[5][0].name.str(), "saturday");
+	const RankSnapshotPtr deep = rankSnapshot("saturday", kDefaultRankCapacity + 20);
+	ASSERT_EQ(deep->size(), kDefaultRankCapacity + 20);
+	EXPECT_TRUE((*deep)[0].name == DayBest[5].back().name.str());
+}
+
+// д   Խ ʰ,  ڿ ù     Խ
+TEST(KeywordTest, RankSnapshotPublishedOnlyAfterPoll) {
+	RankStateGuard guard;
+	guard.clear(1);
+
+	updateKeywordBy("poll-first", "tuesday");
+	const RankSnapshotPtr before = rankSnapshot("tuesday");
+	updateKeywordBy("poll-second", "tuesday");
+	updateKeywordBy("poll-third", "tuesday");
 
+	//   ù (poll-second) Խõǰ, ״  ٽ   Խ 
+	const RankSnapshotPtr lagging = rankSnapshot("tuesday");
+	EXPECT_NE(lagging.get(), before.get());
+	EXPECT_EQ(lagging->size(), 2u);
+	EXPECT_NE(lagging->version(), rankVersion("tuesday"));
+	EXPECT_EQ(rankSnapshot("tuesday").get(), lagging.get());
 
+	//  оǷ    ׶  Խõ,  ִ 纻 ״
+	updateKeywordBy("poll-fourth", "tuesday");
+	const RankSnapshotPtr latest = rankSnapshot("tuesday");
+	EXPECT_EQ(latest->version(), rankVersion("tuesday"));
+	EXPECT_EQ(latest->size(), 4u);
+	EXPECT_EQ(lagging->size(), 2u);
+	EXPECT_TRUE((*lagging)[0].name == string("poll-second"));
 }
 
-TEST(KeywordTest, sameName) {
-	string keyword = "aaaaaab";
-	string day = "monday";
-	updateKeywordBy(keyword, day);
-	string result = updateKeywordBy(keyword, day);
-	EXPECT_EQ(result, keyword);
 
-	keyword = "aaaaaaa";
-	day = "monday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day);
-	EXPECT_EQ(result, result);
+// ġũ (⺻ ࿡ , GTEST_ALSO_RUN_DISABLED_TESTS=1 GTEST_FILTER=BenchmarkTest.*  )
+template <typename F>
+double measureNsPerCall(F f, int iterations) {
+	auto begin = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++)
+		f();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - begin).count() / iterations;
 }
 
-TEST(KeywordTest, mainFunction) {
-	findBetterKeywords();
+// SimilarityFunc  (ּ ó similarityFunc / similer  ):  ޾ ذ 
+int bitParallelScore(const std::string& string1, const std::string& string2) {
+	return g_bitParallelScorer.score(string1, string2);
 }
 
+// 10 ĺ   κ ġϴ query  غ
+void makeBenchmarkLists(std::vector<Node2>& candidates, std::vector<string>& queries) {
+	std::mt19937 rng(2024);
+	for (int c = 0; c < 10; c++) {
+		string name = makeRandomKeyword(rng, 5 + rng() % 10, 26);
+		candidates.push_back({ name, c });
+	}
+	for (int q = 0; q < 64; q++)
+		queries.push_back(mutateKeyword(rng, candidates[rng() % 10].name.str(), rng() % 5, 26));
+}
 
-TEST(KeywordTest, EmptyDouble) {
-	string keyword = "";
-	string day = "monday";
-	updateKeywordBy(keyword, day);
-	string result = updateKeywordBy(keyword, day);
-	EXPECT_EQ(result, keyword);
+//  ȣ  : similer()  ȣ, SimilarityFunc Լ , ø 
+// SimilarityFunc  ִ ¶    ü Ÿ ϹǷ,
+//  ü Ÿ   ȣ(g_scorer->score)    
+TEST(BenchmarkTest, DISABLED_ScorerDispatch) {
+	std::vector<Node2> candidates;
+	std::vector<string> queries;
+	makeBenchmarkLists(candidates, queries);
+	const int iterations = 200000;
+	volatile int sink = 0;
+	size_t q = 0;
 
-	keyword = "";
-	day = "monday";
-	updateKeywordBy(keyword, day);
-	result = updateKeywordBy(keyword, day);
-	EXPECT_EQ(result, result);
+	// Ϸ ȣ  ̸    volatile  
+	SimilarityFunc funcs[] = { &bitParallelScore };
+	volatile int pick = 0;
+
+	double similer_ns = measureNsPerCall([&]() {
+		const string& query = queries[q++ & 63];
+		for (size_t i = 0; i < candidates.size(); i++) {
+			if (similer(candidates[i].name.str(), query)) {
+				sink = sink + static_cast<int>(i);
+				break;
+			}
+		}
+	}, iterations);
+
+	double virtual_score_ns = measureNsPerCall([&]() {
+		const string& query = queries[q++ & 63];
+		for (size_t i = 0; i < candidates.size(); i++) {
+			if (g_scorer->score(candidates[i].name.str(), query) >= SIMILAR_THRESHOLD) {
+				sink = sink + static_cast<int>(i);
+				break;
+			}
+		}
+	}, iterations);
+
+	SimilarityFunc similarityFunc = funcs[pick];
+	double pointer_ns = measureNsPerCall([&]() {
+		const string& query = queries[q++ & 63];
+		for (size_t i = 0; i < candidates.size(); i++) {
+			if (similarityFunc(candidates[i].name.str(), query) >= SIMILAR_THRESHOLD) {
+				sink = sink + static_cast<int>(i);
+				break;
+			}
+		}
+	}, iterations);
+
+	//  ˻   ο 
+	g_prefilterStats = PrefilterStats();
+	double template_ns = measureNsPerCall([&]() {
+		sink = sink + SimilarityEngine<BitParallelPolicy>::findFirstSimilar(queries[q++ & 63], candidates, SIMILAR_THRESHOLD);
+	}, iterations);
+
+	std::cout << "virtual scorer (similer)       : " << similer_ns << " ns / scan\n";
+	std::cout << "virtual scorer (score)         : " << virtual_score_ns << " ns / scan\n";
+	std::cout << "SimilarityFunc pointer (score) : " << pointer_ns << " ns / scan\n";
+	std::cout << "template policy                : " << template_ns << " ns / scan\n";
+	printPrefilterStats(std::cout);
+}
+
+// / ó   λ縦  
+TEST(BenchmarkTest, DISABLED_PrefixHeavy) {
+	const char* stems[] = { "banana", "strawberry_smoothie", "how_to_make_kimchi_stew", "best_running_shoes_for_flat_feet" };
+	const char* endings[] = { "", "s", "es", "ed", "ing" };
+	std::vector<std::pair<string, string>> pairs;
+	for (const char* stem : stems)
+		for (const char* e1 : endings)
+			for (const char* e2 : endings)
+				pairs.push_back({ string(stem) + e1, string(stem) + e2 });
+
+	std::vector<MatchProfile> profiles;
+	for (auto& pair : pairs)
+		profiles.push_back(buildMatchProfile(pair.first));
+
+	const int iterations = 500000;
+	volatile int sink = 0;
+	size_t k = 0;
+
+	double full_band_ns = measureNsPerCall([&]() {
+		const auto& pair = pairs[k++ % pairs.size()];
+		int max_dist = maxDistanceFor(std::max(pair.first.size(), pair.second.size()), SIMILAR_THRESHOLD);
+		sink = sink + levenshteinBoundedRaw(pair.first.data(), static_cast<int>(pair.first.size()),
+			pair.second.data(), static_cast<int>(pair.second.size()), max_dist);
+	}, iterations);
+	double trimmed_band_ns = measureNsPerCall([&]() {
+		const auto& pair = pairs[k++ % pairs.size()];
+		int max_dist = maxDistanceFor(std::max(pair.first.size(), pair.second.size()), SIMILAR_THRESHOLD);
+		sink = sink + levenshteinBounded(pair.first, pair.second, max_dist);
+	}, iterations);
+	double full_myers_ns = measureNsPerCall([&]() {
+		size_t i = k++ % pairs.size();
+		sink = sink + myersDistanceProfile(profiles[i], pairs[i].second, 64);
+	}, iterations);
+	double trimmed_myers_ns = measureNsPerCall([&]() {
+		size_t i = k++ % pairs.size();
+		sink = sink + myersDistanceProfileTrimmed(profiles[i], pairs[i].first, pairs[i].second, 64);
+	}, iterations);
+
+	std::cout << "band DP            : " << full_band_ns << " ns -> trimmed " << trimmed_band_ns << " ns\n";
+	std::cout << "bit-parallel       : " << full_myers_ns << " ns -> trimmed " << trimmed_myers_ns << " ns\n";
+}
+
+// K    : ׸ ϳ point  +  Ű ( ū ׸ ü)
+template <typename Update>
+double measureRankUpdates(size_t k, Update update) {
+	const int iterations = 200000 / static_cast<int>(std::max<size_t>(1, k / 10));
+	return measureNsPerCall(update, iterations);
+}
+
+TEST(BenchmarkTest, DISABLED_RankCapacity) {
+	std::vector<InternedKeyword> pool;
+	std::vector<string> names;
+	for (int i = 0; i < 4096; i++) {
+		names.push_back("rank" + std::to_string(i));
+		pool.push_back(names.back());
+	}
+	volatile int sink = 0;
+
+	// Ը ü ϴ  (  ׸ ü)
+	auto run_sorted = [&](size_t k) {
+		std::vector<Node2> list;
+		std::mt19937 rng(20);
+		int point = 0;
+		size_t n = 0;
+		while (list.size() < k)
+			list.push_back({ names[n++ & 4095], ++point });
+		double ns = measureRankUpdates(k, [&]() {
+			size_t slot = rng() % list.size();
+			list[slot].point = increaseNodePoint(list[slot].point);
+			std::sort(list.begin(), list.end());
+			++point;
+			if (list.front().point < point) {
+				list.erase(list.begin());
+				list.push_back({ names[n++ & 4095], point });
+				std::sort(list.begin(), list.end());
+			}
+			sink = sink ^ list[0].point;
+		});
+		std::cout << "K=" << k << " vector + sort      : " << ns << " ns / update\n";
+	};
+
+	auto run_ordered = [&](size_t k) {
+		std::vector<Node2> list;
+		list.reserve(k);
+		std::mt19937 rng(20);
+		int point = 0;
+		size_t n = 0;
+		while (list.size() < k)
+			insertRanked(list, k, names[n++ & 4095], ++point, nullptr);
+		double ns = measureRankUpdates(k, [&]() {
+			size_t slot = rng() % list.size();
+			list[slot].point = increaseNodePoint(list[slot].point);
+			raiseRanked(list, slot, nullptr);
+			insertRanked(list, k, names[n++ & 4095], ++point, nullptr);
+			sink = sink ^ list[0].point;
+		});
+		std::cout << "K=" << k << " vector ordered     : " << ns << " ns / update\n";
+	};
+
+	//   :  /  /  Բ ġ   +     
+	// (  Ž O(K)  ȱ,  / ֱ O(K) ̵ и  )
+	auto run_admit = [&](size_t k) {
+		RankStateGuard guard;
+		guard.clear(0);
+		setRankCapacity(k);
+		std::mt19937 rng(20);
+		int point = 0;
+		size_t n = 0;
+		while (DayBest[0].size() < k)
+			addKeyword(DayBest[0], names[n++ & 4095], ++point);
+		double ns = measureRankUpdates(k, [&]() {
+			std::vector<Node2>& list = DayBest[0];
+			size_t slot = rng() % list.size();
+			beginRankWrite(0);
+			list[slot].point = increaseNodePoint(list[slot].point);
+			g_heavyHitters[0].add(list[slot].name.hash());
+			raiseRanked(list, slot, &g_rankIndex[0], &g_rankColumns[0]);
+			endRankWrite(0);
+			addKeyword(list, names[n++ & 4095], ++point);
+			sink = sink ^ list[0].point;
+		});
+		std::cout << "K=" << k << " ranked list + evict: " << ns << " ns / update\n";
+	};
+
+	for (size_t k : { 10, 100, 1000 }) {
+		run_sorted(k);
+		run_ordered(k);
+		run_admit(k);
+	}
+}
+
+TEST(BenchmarkTest, DISABLED_LazyResetScore) {
+	RankStateGuard guard;
+
+	for (size_t k : { 10, 100, 1000, 10000 }) {
+		setRankCapacity(k);
+		for (int list_id = 0; list_id < kRankListCount; ++list_id) {
+			std::vector<Node2>& list = rankList(list_id);
+			list.clear();
+			for (size_t i = 0; i < k; i++)
+				list.push_back({ "reset" + std::to_string(list_id * k + i), static_cast<int>(i + 1) * 100 });
+			rankListChanged(list_id, list);
+		}
+		const int iterations = 200;
+
+		//  : ѱ ȣ 9  ü ٽ 
+		double eager = measureNsPerCall([&]() {
+			resetScore();
+			for (int list_id = 0; list_id < kRankListCount; ++list_id)
+				syncScoreGeneration(list_id);
+		}, iterations);
+		//  : ѱ ȣ ڽ   ϸ ٽ 
+		double lazy = measureNsPerCall([&]() {
+			resetScore();
+			syncScoreGeneration(0);
+			syncScoreGeneration(7);
+		}, iterations);
+		std::cout << "K=" << k << " threshold call eager: " << eager << " ns, lazy: " << lazy << " ns\n";
+	}
+}
+
+// ϵ ĳ ̽ ī (Linux perf_event,    -1)
+class CacheMissCounter {
+public:
+	CacheMissCounter() {
+#ifdef __linux__
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = PERF_COUNT_HW_CACHE_MISSES;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		fd_ = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+	}
+	~CacheMissCounter() {
+#ifdef __linux__
+		if (fd_ >= 0)
+			close(fd_);
+#endif
+	}
+
+	template <typename F>
+	long long count(F f) {
+#ifdef __linux__
+		if (fd_ >= 0) {
+			ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+			ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+			f();
+			ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+			long long value = 0;
+			if (read(fd_, &value, sizeof(value)) == static_cast<ssize_t>(sizeof(value)))
+				return value;
+			return -1;
+		}
+#endif
+		f();
+		return -1;
+	}
+
+private:
+	int fd_ = -1;
+};
+
+// ĳÿ   ŭ   ̰ ٸ Ƿ  
+//  ġ(AoS): ׸񸶴 id Ű ǥ ؽ / ̸ 
+//  ġ(SoA):  (RankColumns) ؽ / ̸   (findSimilarIndex   )
+//     ȸ   ޸ ġǷ ޸ ȸ /  Ƚ 
+TEST(BenchmarkTest, DISABLED_ScanCacheMisses) {
+	std::mt19937 rng(2020);
+	std::vector<std::vector<Node2>> lists(4000);
+	std::vector<RankColumns> columns(lists.size());
+	for (size_t l = 0; l < lists.size(); l++) {
+		for (int i = 0; i < 10; i++)
+			lists[l].push_back({ makeRandomKeyword(rng, 4 + rng() % 8, 26), i });
+		columns[l].rebuild(lists[l]);
+	}
+	const string query = makeRandomKeyword(rng, 40, 26);
+	const uint64_t query_hash = hashKeyword(query);
+	uint32_t generation = 1u << 30;
+	volatile int sink = 0;
+
+	auto aos_scan = [&]() {
+		BitParallelPolicy::Query prepared(query);
+		++generation;
+		for (size_t l = 0; l < lists.size(); l++) {
+			RankListVerdicts verdicts{ query_hash, generation, static_cast<int>(l % kRankListCount) };
+			for (size_t i = 0; i < lists[l].size(); i++) {
+				const Node2& candidate = lists[l][i];
+				bool found;
+				if (!verdicts.lookup(candidate.name.hash(), found)) {
+					found = SimilarityEngine<BitParallelPolicy>::similar(prepared, candidate, SIMILAR_THRESHOLD);
+					verdicts.store(candidate.name.hash(), found);
+				}
+				if (found) {
+					sink = sink + static_cast<int>(i);
+					break;
+				}
+			}
+		}
+	};
+	auto soa_scan = [&]() {
+		BitParallelPolicy::Query prepared(query);
+		++generation;
+		for (size_t l = 0; l < lists.size(); l++) {
+			RankListVerdicts verdicts{ query_hash, generation, static_cast<int>(l % kRankListCount) };
+			sink = sink + SimilarityEngine<BitParallelPolicy>::findFirstSimilar(prepared, lists[l], columns[l],
+				SIMILAR_THRESHOLD, verdicts);
+		}
+	};
+
+	CacheMissCounter counter;
+	aos_scan();
+	soa_scan();
+	g_similarityMemoStats = SimilarityMemoStats();
+	auto begin = std::chrono::steady_clock::now();
+	long long aos_misses = counter.count(aos_scan);
+	auto middle = std::chrono::steady_clock::now();
+	long long soa_misses = counter.count(soa_scan);
+	auto end = std::chrono::steady_clock::now();
+
+	const double candidates = 4000.0 * 10;
+	std::cout << "entries (AoS)      : " << std::chrono::duration<double, std::nano>(middle - begin).count() / candidates
+		<< " ns / candidate, cache misses " << aos_misses << "\n";
+	std::cout << "columns (SoA)      : " << std::chrono::duration<double, std::nano>(end - middle).count() / candidates
+		<< " ns / candidate, cache misses " << soa_misses << "\n";
+	if (aos_misses < 0)
+		std::cout << "(perf_event ĳ ̽ ī͸   )\n";
+	printSimilarityMemoStats(std::cout);
 }
 
+// ġ Ÿ  ǿ Ÿ scorer OSA scorer 10 ĺ Ž 
+TEST(BenchmarkTest, DISABLED_OsaScorer) {
+	std::vector<Node2> candidates;
+	std::vector<string> queries;
+	makeBenchmarkLists(candidates, queries);
+	std::mt19937 rng(15);
+	for (string& query : queries)
+		query = transposeKeyword(rng, query, 1);
+	const int iterations = 200000;
+	volatile int sink = 0;
+	size_t q = 0;
+
+	// ⺻ (Ʈ  Ÿ)  ο Ŀθ OSA ٲ 
+	const ISimilarityScorer* scorers[] = { &g_bitParallelScorer, &g_osaScorer };
+	double bit_parallel_ns = measureNsPerCall([&]() {
+		sink = sink + scorers[0]->findFirstSimilar(queries[q++ & 63], candidates, SIMILAR_THRESHOLD);
+	}, iterations);
+	double osa_ns = measureNsPerCall([&]() {
+		sink = sink + scorers[1]->findFirstSimilar(queries[q++ & 63], candidates, SIMILAR_THRESHOLD);
+	}, iterations);
+
+	std::cout << "bit-parallel scorer: " << bit_parallel_ns << " ns / scan\n";
+	std::cout << "osa scorer         : " << osa_ns << " ns / scan\n";
+}
 
 int main() {
 
@@ -488,27 +5085,18 @@ int main() {
 // ȭ
 int increaseNodePoint(int point)
 {
-	point += static_cast<int>(point * 0.1);
-	if (point >= 2100000000) 
-		point = 2100000000;
-	return point;
+	//  1.95e9 ̻󿡼 int ϸ    ħ
+	long long raised = point + static_cast<long long>(point * 0.1);
+	if (raised >= 2100000000)
+		raised = 2100000000;
+	return static_cast<int>(raised);
 }
 
 void resetScore()
 {
 	UZ = 9;
-	for (int i = 0; i < 7; i++) {
-		int num = 1;
-		for (Node2& node : DayBest[i]) {
-			node.point = num++;
-		}
-	}
-	for (int i = 0; i < 2; i++) {
-		int num = 1;
-		for (Node2& node : twoBest[i]) {
-			node.point = num++;
-		}
-	}
+	// Ϻ İ  ȭ syncScoreGeneration()    
+	g_scoreGeneration++;
 }
 
 